@@ -0,0 +1,282 @@
+/**
+ * @file DeviceManager.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief DeviceManager Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The DeviceManager object follows the connection and disconnection of the
+ * TE923 devices through the libusb hotplug callbacks. Each station gets its
+ * own acquisition worker, which is paused while its device is missing and
+ * resumed as soon as it reappears.
+ */
+
+#include "DeviceManager.h"
+
+#include <iostream>
+#include <set>
+
+#include "HistoryReader.h"
+
+using namespace std;
+
+/// Maximum time the event thread blocks before checking if it must stop (ms).
+const int EVENT_LOOP_PERIOD = 500;
+
+/**
+ * @brief Construct a new DeviceManager object
+ *
+ * Nothing is initialized until start() is called.
+ */
+DeviceManager::DeviceManager() {
+    ctx = NULL;
+    hotplug_enabled = false;
+    running = false;
+    async_mode = false;
+    history_records = TE923_HISTORY_RECORDS_SMALL;
+}
+
+/**
+ * @brief Destroy the DeviceManager object
+ */
+DeviceManager::~DeviceManager() {
+    stop();
+}
+
+/**
+ * @brief Start following the devices
+ *
+ * Initializes libusb, registers the hotplug callback for the TE923 IDs (which
+ * also reports the devices already attached) and starts the event thread.
+ *
+ * @param newHandler Function called with each frame read by the workers
+ * @return short int Result of the execution of the function.
+ */
+short int DeviceManager::start(FrameHandler newHandler) {
+    int retValue;
+
+    if (ctx != NULL)
+        return 0;
+
+    handler = newHandler;
+
+    retValue = libusb_init(&ctx);
+    if (retValue < 0) {
+        cerr << "Error initializing libusb" << endl;
+        ctx = NULL;
+        return -1;
+    }
+
+    if (libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+        retValue = libusb_hotplug_register_callback(ctx,
+            LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+            LIBUSB_HOTPLUG_ENUMERATE, TE923_VENDOR_ID, TE923_PRODUCT_ID,
+            LIBUSB_HOTPLUG_MATCH_ANY, hotplugCallback, this, &hotplug_handle);
+        if (retValue < 0) {
+            cerr << "Error registering the hotplug callback: " << libusb_strerror(libusb_error(retValue)) << endl;
+        } else {
+            hotplug_enabled = true;
+        }
+    }
+    if (!hotplug_enabled) {
+        cerr << "Hotplug not available, the devices will be polled" << endl;
+        scanDevices();
+    }
+
+    running = true;
+    event_thread = thread(&DeviceManager::eventLoop, this);
+
+    return 0;
+}
+
+/**
+ * @brief Stop all the workers and release all the resources
+ */
+void DeviceManager::stop() {
+    if (ctx == NULL)
+        return;
+
+    running = false;
+    if (hotplug_enabled) {
+        libusb_hotplug_deregister_callback(ctx, hotplug_handle);
+        hotplug_enabled = false;
+    }
+    if (event_thread.joinable())
+        event_thread.join();
+
+    {
+        lock_guard<mutex> guard(workers_lock);
+        for (auto &it : workers) {
+            delete it.second;
+        }
+        workers.clear();
+    }
+
+    libusb_exit(ctx);
+    ctx = NULL;
+}
+
+/**
+ * @brief Select the acquisition mode of the workers
+ *
+ * Only affects the workers created after the call, so it has to be called
+ * before start().
+ *
+ * @param newAsyncMode True to use the event-driven transfers, false to use
+ * the blocking ones.
+ */
+void DeviceManager::setAsyncMode(bool newAsyncMode) {
+    async_mode = newAsyncMode;
+}
+
+/**
+ * @brief Select the size of the history ring of the stations
+ *
+ * Only affects the workers created after the call, so it has to be called
+ * before start().
+ *
+ * @param newHistoryRecords Number of records of the history ring
+ */
+void DeviceManager::setHistoryRecords(int newHistoryRecords) {
+    history_records = newHistoryRecords;
+}
+
+/**
+ * @brief Select the directory where the workers capture the frames
+ *
+ * Only affects the workers created after the call, so it has to be called
+ * before start().
+ *
+ * @param newCaptureDir Directory of the capture, empty to not capture
+ */
+void DeviceManager::setCaptureDir(const std::string& newCaptureDir) {
+    capture_dir = newCaptureDir;
+}
+
+/**
+ * @brief Get the number of stations seen since the start
+ *
+ * @return int Number of stations (with a worker)
+ */
+int DeviceManager::getStationCount() {
+    lock_guard<mutex> guard(workers_lock);
+    return workers.size();
+}
+
+/**
+ * @brief Callback called by libusb when a TE923 device arrives or leaves
+ *
+ * It runs in the event thread, so it only records the change; the device is
+ * opened by the worker of its station.
+ *
+ * @param cbCtx Context of the event
+ * @param cbDevice Device that arrived or left
+ * @param event Type of event
+ * @param user_data DeviceManager that registered the callback
+ * @return int Always 0, to keep the callback registered
+ */
+int LIBUSB_CALL DeviceManager::hotplugCallback(libusb_context *cbCtx, libusb_device *cbDevice, libusb_hotplug_event event, void *user_data) {
+    DeviceManager *manager = (DeviceManager*)user_data;
+
+    (void)cbCtx;
+    if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+        manager->deviceArrived(cbDevice);
+    } else if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT) {
+        manager->deviceLeft(cbDevice);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Loop of the event thread
+ *
+ * Handles the libusb events (hotplug and transfers) until the manager is
+ * stopped. Without hotplug support, the devices are polled in each loop.
+ */
+void DeviceManager::eventLoop() {
+    while (running) {
+        if (hotplug_enabled) {
+            timeval tv = {0, EVENT_LOOP_PERIOD * 1000};
+            libusb_handle_events_timeout_completed(ctx, &tv, NULL);
+        } else {
+            this_thread::sleep_for(chrono::milliseconds(EVENT_LOOP_PERIOD));
+            scanDevices();
+        }
+    }
+}
+
+/**
+ * @brief Hand an arrived device to the worker of its station
+ *
+ * The worker is created (and started) the first time a station is seen.
+ *
+ * @param newDevice Device that arrived
+ */
+void DeviceManager::deviceArrived(libusb_device *newDevice) {
+    string station_id = StationWorker::stationIdOf(newDevice);
+    StationWorker *worker;
+    lock_guard<mutex> guard(workers_lock);
+
+    auto it = workers.find(station_id);
+    if (it == workers.end()) {
+        worker = new StationWorker(ctx, station_id, handler, async_mode, history_records);
+        workers[station_id] = worker;
+        worker->setCaptureDir(capture_dir);
+        worker->start();
+    } else {
+        worker = it->second;
+    }
+    worker->deviceArrived(newDevice);
+}
+
+/**
+ * @brief Report a removed device to the workers
+ *
+ * Each worker ignores the devices that are not its own.
+ *
+ * @param oldDevice Device that left
+ */
+void DeviceManager::deviceLeft(libusb_device *oldDevice) {
+    lock_guard<mutex> guard(workers_lock);
+
+    for (auto &it : workers) {
+        it.second->deviceLeft(oldDevice);
+    }
+}
+
+/**
+ * @brief Look for the devices in the current device list
+ *
+ * Used when hotplug is not available. The stations whose device is not in
+ * the list are reported as removed.
+ */
+void DeviceManager::scanDevices() {
+    libusb_device **devs;
+    libusb_device_descriptor usbDes;
+    set<string> present;
+    ssize_t counter;
+
+    counter = libusb_get_device_list(ctx, &devs);
+    if (counter < 0) {
+        cerr << "Error listing the devices" << endl;
+        return;
+    }
+    for (int i = 0; i < counter; i++) {
+        if (libusb_get_device_descriptor(devs[i], &usbDes) < 0)
+            continue;
+        if (usbDes.idVendor == TE923_VENDOR_ID && usbDes.idProduct == TE923_PRODUCT_ID) {
+            present.insert(StationWorker::stationIdOf(devs[i]));
+            deviceArrived(devs[i]);
+        }
+    }
+    libusb_free_device_list(devs, 1);
+
+    lock_guard<mutex> guard(workers_lock);
+    for (auto &it : workers) {
+        if (present.count(it.first) == 0)
+            it.second->deviceLeft(NULL);
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file DeviceManager.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief DeviceManager Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The DeviceManager object follows the connection and disconnection of the
+ * TE923 devices through the libusb hotplug callbacks. Each station gets its
+ * own acquisition worker, which is paused while its device is missing and
+ * resumed as soon as it reappears.
+ */
+
+#ifndef DEVICEMANAGER_H
+#define DEVICEMANAGER_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <libusb-1.0/libusb.h>
+
+#include "StationWorker.h"
+
+/**
+ * @brief DeviceManager Class
+ *
+ * Owns the libusb context and a thread handling its events. Each TE923
+ * device reported by the hotplug callback gets its own StationWorker, keyed
+ * by the bus and port path, so every station is sampled independently. The
+ * callback only records the changes; the devices are opened by the workers.
+ * When the libusb build has no hotplug support, the devices are polled.
+ */
+class DeviceManager
+{
+    /* DeviceManager attributes */
+    protected:
+        /// libusb context shared by the manager and the workers.
+        libusb_context *ctx;
+        /// Handle of the registered hotplug callback.
+        libusb_hotplug_callback_handle hotplug_handle;
+        /// The hotplug callback is registered.
+        bool hotplug_enabled;
+        /// Thread handling the libusb events.
+        std::thread event_thread;
+        /// The event thread has to keep running.
+        std::atomic<bool> running;
+        /// Protects the workers map.
+        std::mutex workers_lock;
+        /// Acquisition worker of each station, by station identifier.
+        std::map<std::string, StationWorker*> workers;
+        /// Function called with each frame read by the workers.
+        FrameHandler handler;
+        /// Acquisition mode of the workers created.
+        bool async_mode;
+        /// Number of records of the history ring of the stations.
+        int history_records;
+        /// Directory where the frames are captured (empty if not capturing).
+        std::string capture_dir;
+
+        static int LIBUSB_CALL hotplugCallback(libusb_context *cbCtx, libusb_device *cbDevice, libusb_hotplug_event event, void *user_data);
+        void eventLoop();
+        void deviceArrived(libusb_device *newDevice);
+        void deviceLeft(libusb_device *oldDevice);
+        void scanDevices();
+
+    /* DeviceManager public methods */
+    public:
+        DeviceManager();
+        ~DeviceManager();
+
+        DeviceManager(const DeviceManager&) = delete;
+        DeviceManager& operator=(const DeviceManager&) = delete;
+
+        short int start(FrameHandler newHandler);
+        void stop();
+        void setAsyncMode(bool newAsyncMode);
+        void setHistoryRecords(int newHistoryRecords);
+        void setCaptureDir(const std::string& newCaptureDir);
+
+        int getStationCount();
+};
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file FrameLog.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FrameLog Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FrameLog object stores the raw frames received from a station in a
+ * compact binary file, and reads them back, so the frames seen in the field
+ * can be replayed later through the decoding pipeline.
+ */
+
+#include "FrameLog.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Construct a new FrameLog object
+ *
+ * No file is opened until openWrite() or openRead() is called.
+ */
+FrameLog::FrameLog() {
+    writing = false;
+}
+
+/**
+ * @brief Destroy the FrameLog object
+ */
+FrameLog::~FrameLog() {
+    close();
+}
+
+/**
+ * @brief Open a log to append frames to it
+ *
+ * If the file does not exist (or is empty) it is created with the header of
+ * the format.
+ *
+ * @param path Path of the log file
+ * @return short int Result of the execution of the function.
+ */
+short int FrameLog::openWrite(const std::string& path) {
+    uint16_t frame_len = BUFLEN;
+
+    close();
+    file.open(path, ios::in | ios::out | ios::binary | ios::app);
+    if (!file.is_open()) {
+        file.clear();
+        file.open(path, ios::out | ios::binary | ios::app);
+    }
+    if (!file.is_open()) {
+        cerr << "Cannot open the frame log " << path << endl;
+        return -1;
+    }
+
+    file.seekg(0, ios::end);
+    if (file.tellg() <= 0) {
+        file.clear();
+        file.write(FRAMELOG_MAGIC, sizeof(FRAMELOG_MAGIC));
+        file.write((const char*)&FRAMELOG_VERSION, sizeof(FRAMELOG_VERSION));
+        file.write((const char*)&frame_len, sizeof(frame_len));
+        file.flush();
+    }
+    writing = true;
+
+    return 0;
+}
+
+/**
+ * @brief Open a log to read its frames from the beginning
+ *
+ * @param path Path of the log file
+ * @return short int Result of the execution of the function.
+ */
+short int FrameLog::openRead(const std::string& path) {
+    char magic[sizeof(FRAMELOG_MAGIC)];
+    uint16_t version = 0;
+    uint16_t frame_len = 0;
+
+    close();
+    file.open(path, ios::in | ios::binary);
+    if (!file.is_open()) {
+        cerr << "Cannot open the frame log " << path << endl;
+        return -1;
+    }
+
+    file.read(magic, sizeof(magic));
+    file.read((char*)&version, sizeof(version));
+    file.read((char*)&frame_len, sizeof(frame_len));
+    if (!file || memcmp(magic, FRAMELOG_MAGIC, sizeof(magic)) != 0 ||
+        version != FRAMELOG_VERSION || frame_len != BUFLEN) {
+        cerr << "Invalid frame log " << path << endl;
+        close();
+        return -2;
+    }
+    writing = false;
+
+    return 0;
+}
+
+/**
+ * @brief Close the log file
+ */
+void FrameLog::close() {
+    if (file.is_open())
+        file.close();
+    file.clear();
+    writing = false;
+}
+
+/**
+ * @brief Append a frame received now to the log
+ *
+ * @param frame Raw frame received
+ * @param crc_ok The CRC of the frame was valid
+ * @return short int Result of the execution of the function.
+ */
+short int FrameLog::append(const unsigned char* frame, bool crc_ok) {
+    FrameLogRecord record;
+
+    record.timestamp_us = chrono::duration_cast<chrono::microseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    record.crc_ok = crc_ok;
+    memcpy(record.frame, frame, BUFLEN);
+
+    return append(record);
+}
+
+/**
+ * @brief Append a record to the log
+ *
+ * The file is flushed after each record, so a crash does not lose the last
+ * frames received.
+ *
+ * @param record Record to append
+ * @return short int Result of the execution of the function.
+ */
+short int FrameLog::append(const FrameLogRecord& record) {
+    uint8_t crc_ok = record.crc_ok ? 1 : 0;
+
+    if (!writing)
+        return -1;
+
+    file.write((const char*)&record.timestamp_us, sizeof(record.timestamp_us));
+    file.write((const char*)&crc_ok, sizeof(crc_ok));
+    file.write((const char*)record.frame, BUFLEN);
+    file.flush();
+
+    return file ? 0 : -2;
+}
+
+/**
+ * @brief Read the next record of the log
+ *
+ * @param record Record read
+ * @return short int 0 if a record was read, 1 at the end of the log, negative
+ * if the log is not opened to read.
+ */
+short int FrameLog::next(FrameLogRecord& record) {
+    uint8_t crc_ok = 0;
+
+    if (writing || !file.is_open())
+        return -1;
+
+    file.read((char*)&record.timestamp_us, sizeof(record.timestamp_us));
+    file.read((char*)&crc_ok, sizeof(crc_ok));
+    file.read((char*)record.frame, BUFLEN);
+    if (!file)
+        return 1;
+    record.crc_ok = (crc_ok != 0);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file FrameLog.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FrameLog Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FrameLog object stores the raw frames received from a station in a
+ * compact binary file, and reads them back, so the frames seen in the field
+ * can be replayed later through the decoding pipeline.
+ */
+
+#ifndef FRAMELOG_H
+#define FRAMELOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "data_decoder.h"
+
+/// Magic number at the start of the frame log files.
+const char FRAMELOG_MAGIC[4] = {'W', 'S', '3', 'F'};
+/// Version of the frame log format.
+const uint16_t FRAMELOG_VERSION = 1;
+
+/**
+ * @brief Record of the frame log
+ *
+ * Stored in the file as the timestamp (8 bytes), the CRC result (1 byte) and
+ * the raw frame (BUFLEN bytes), without padding.
+ */
+struct FrameLogRecord {
+    /// Time when the frame was received, in microseconds since the epoch.
+    int64_t timestamp_us;
+    /// The CRC of the frame was valid.
+    bool crc_ok;
+    /// Raw frame, as received from the station.
+    unsigned char frame[BUFLEN];
+};
+
+/**
+ * @brief FrameLog Class
+ *
+ * Binary log of raw frames. A log is opened either to append frames to it
+ * (creating it if needed) or to read them from the beginning.
+ */
+class FrameLog
+{
+    /* FrameLog attributes */
+    protected:
+        /// File of the log.
+        std::fstream file;
+        /// The log is opened to append frames.
+        bool writing;
+
+    /* FrameLog public methods */
+    public:
+        FrameLog();
+        ~FrameLog();
+
+        FrameLog(const FrameLog&) = delete;
+        FrameLog& operator=(const FrameLog&) = delete;
+
+        short int openWrite(const std::string& path);
+        short int openRead(const std::string& path);
+        void close();
+
+        short int append(const unsigned char* frame, bool crc_ok);
+        short int append(const FrameLogRecord& record);
+        short int next(FrameLogRecord& record);
+};
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file FramePool.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FramePool Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FramePool object keeps a fixed set of slots where a frame is read and
+ * decoded in place. The slots are shared through reference-counted handles
+ * from the USB layer to the decoder and the sinks, so a frame is never copied
+ * nor allocated while acquiring.
+ */
+
+#include "FramePool.h"
+
+using namespace std;
+
+/**
+ * @brief Construct an empty FrameHandle object
+ */
+FrameHandle::FrameHandle() {
+    slot = NULL;
+}
+
+/**
+ * @brief Construct a new FrameHandle object
+ *
+ * Takes a new reference to the slot.
+ *
+ * @param newSlot Slot to reference
+ */
+FrameHandle::FrameHandle(FrameSlot *newSlot) {
+    slot = newSlot;
+    if (slot != NULL)
+        slot->refs.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * @brief Construct a new FrameHandle object sharing the slot of another one
+ *
+ * @param other Handle to copy
+ */
+FrameHandle::FrameHandle(const FrameHandle& other) : FrameHandle(other.slot) {
+}
+
+/**
+ * @brief Construct a new FrameHandle object taking the slot of another one
+ *
+ * @param other Handle to move, left empty
+ */
+FrameHandle::FrameHandle(FrameHandle&& other) {
+    slot = other.slot;
+    other.slot = NULL;
+}
+
+/**
+ * @brief Destroy the FrameHandle object
+ *
+ * The slot is returned to its pool if this is the last handle.
+ */
+FrameHandle::~FrameHandle() {
+    reset();
+}
+
+/**
+ * @brief Replace the slot referenced by the handle
+ *
+ * @param other Handle to share
+ * @return FrameHandle& This handle
+ */
+FrameHandle& FrameHandle::operator=(FrameHandle other) {
+    FrameSlot *aux = slot;
+    slot = other.slot;
+    other.slot = aux;
+    return *this;
+}
+
+/**
+ * @brief Check if the handle references a slot
+ *
+ * @return true The handle is empty
+ * @return false The handle references a slot
+ */
+bool FrameHandle::empty() const {
+    return slot == NULL;
+}
+
+/**
+ * @brief Drop the reference of the handle, leaving it empty
+ */
+void FrameHandle::reset() {
+    if (slot != NULL && slot->refs.fetch_sub(1, memory_order_acq_rel) == 1)
+        slot->pool->release(slot);
+    slot = NULL;
+}
+
+/**
+ * @brief Get the raw frame of the slot
+ *
+ * @return RawFrame& Frame of BUFLEN bytes
+ */
+RawFrame& FrameHandle::frame() const {
+    return slot->frame;
+}
+
+/**
+ * @brief Get the time when the frame of the slot was read
+ *
+ * @return unsigned int& Timestamp of the frame
+ */
+unsigned int& FrameHandle::timestamp() const {
+    return slot->timestamp;
+}
+
+/**
+ * @brief Get the Observation decoded from the frame of the slot
+ *
+ * @return Observation& Observation of the slot
+ */
+Observation& FrameHandle::observation() const {
+    return slot->observation;
+}
+
+/**
+ * @brief Construct a new FramePool object
+ *
+ * All the slots start free.
+ */
+FramePool::FramePool() {
+    for (int i = 0; i < FRAME_POOL_SIZE; i++) {
+        slots[i].timestamp = 0;
+        slots[i].refs.store(0, memory_order_relaxed);
+        slots[i].pool = this;
+        free_slots[i] = &slots[i];
+    }
+    free_count = FRAME_POOL_SIZE;
+}
+
+/**
+ * @brief Take a free slot of the pool
+ *
+ * The Observation of the slot is cleared, keeping the storage of its
+ * station identifier.
+ *
+ * @return FrameHandle Handle to the slot, empty if every slot is in use
+ */
+FrameHandle FramePool::acquire() {
+    FrameSlot *slot;
+
+    {
+        lock_guard<mutex> guard(free_lock);
+        if (free_count == 0)
+            return FrameHandle();
+        slot = free_slots[--free_count];
+    }
+
+    slot->timestamp = 0;
+    slot->observation.clear();
+
+    return FrameHandle(slot);
+}
+
+/**
+ * @brief Return a slot to the pool
+ *
+ * Called by the last handle of the slot.
+ *
+ * @param slot Slot to return
+ */
+void FramePool::release(FrameSlot *slot) {
+    lock_guard<mutex> guard(free_lock);
+    free_slots[free_count++] = slot;
+}
+
+/**
+ * @brief Get the number of free slots
+ *
+ * @return int Slots available to acquire
+ */
+int FramePool::getFreeCount() {
+    lock_guard<mutex> guard(free_lock);
+    return free_count;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file FramePool.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FramePool Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FramePool object keeps a fixed set of slots where a frame is read and
+ * decoded in place. The slots are shared through reference-counted handles
+ * from the USB layer to the decoder and the sinks, so a frame is never copied
+ * nor allocated while acquiring.
+ */
+
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <atomic>
+#include <mutex>
+
+#include "data_decoder.h"
+#include "Observation.h"
+
+/// Number of slots of a frame pool.
+const int FRAME_POOL_SIZE = 8;
+
+class FramePool;
+
+/**
+ * @brief Slot of a frame pool
+ *
+ * Holds a raw frame, the time it was read and the Observation decoded from
+ * it.
+ */
+struct FrameSlot {
+    /// Raw frame, as read from the station.
+    RawFrame frame;
+    /// Time when the frame was read.
+    unsigned int timestamp;
+    /// Observation decoded from the frame.
+    Observation observation;
+    /// Number of handles to the slot.
+    std::atomic<int> refs;
+    /// Pool the slot belongs to.
+    FramePool *pool;
+};
+
+/**
+ * @brief FrameHandle Class
+ *
+ * Reference to a slot of a FramePool. Copying the handle shares the slot, and
+ * the slot returns to its pool when the last handle is destroyed.
+ */
+class FrameHandle
+{
+    /* FrameHandle attributes */
+    protected:
+        /// Slot referenced (NULL for an empty handle).
+        FrameSlot *slot;
+
+    /* FrameHandle public methods */
+    public:
+        FrameHandle();
+        explicit FrameHandle(FrameSlot *newSlot);
+        FrameHandle(const FrameHandle& other);
+        FrameHandle(FrameHandle&& other);
+        ~FrameHandle();
+
+        FrameHandle& operator=(FrameHandle other);
+
+        bool empty() const;
+        void reset();
+
+        RawFrame& frame() const;
+        unsigned int& timestamp() const;
+        Observation& observation() const;
+};
+
+/**
+ * @brief FramePool Class
+ *
+ * Fixed set of FRAME_POOL_SIZE slots. The free slots are kept in a stack, so
+ * acquiring and releasing a slot never allocates. The pool has to outlive
+ * every handle acquired from it.
+ */
+class FramePool
+{
+    /* FramePool attributes */
+    protected:
+        /// Slots of the pool.
+        FrameSlot slots[FRAME_POOL_SIZE];
+        /// Protects the free stack.
+        std::mutex free_lock;
+        /// Stack of the free slots.
+        FrameSlot *free_slots[FRAME_POOL_SIZE];
+        /// Number of slots in the free stack.
+        int free_count;
+
+    /* FramePool public methods */
+    public:
+        FramePool();
+
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        FrameHandle acquire();
+        void release(FrameSlot *slot);
+
+        int getFreeCount();
+};
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file FrameSource.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FrameSource interface is implemented by everything able to provide
+ * current readings frames to the pipeline: a real station, a capture file or
+ * a simulated station.
+ */
+
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+/**
+ * @brief FrameSource Class
+ *
+ * Source of current readings frames, laid out as received from a TE923
+ * station. Implemented by UsbFrameSource, ReplayFrameSource and
+ * SimulatedFrameSource.
+ */
+class FrameSource
+{
+    /* FrameSource public methods */
+    public:
+        virtual ~FrameSource() {}
+
+        /**
+         * @brief Obtain the next frame of the source
+         *
+         * @param receive_buffer Buffer where the frame is stored.
+         * @param timestamp Time when the frame was measured.
+         * @return short int 0 if a frame was read, 1 if the source has no
+         * more frames, negative if the read failed.
+         */
+        virtual short int readFrame(unsigned char* receive_buffer, unsigned int &timestamp) = 0;
+};
+
+#endif
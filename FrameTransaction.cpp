@@ -0,0 +1,213 @@
+/**
+ * @file FrameTransaction.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FrameTransaction Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FrameTransaction object keeps the state of the read of a memory block
+ * of the station across several request/response exchanges, so a short or
+ * corrupt answer only costs the exchange needed to complete or repair it.
+ */
+
+#include "FrameTransaction.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "data_decoder.h"
+
+using namespace std;
+
+/**
+ * @brief Construct a new FrameTransaction object
+ *
+ * The transaction has no buffer until it is reset.
+ */
+FrameTransaction::FrameTransaction() {
+    frame = NULL;
+    received = 0;
+    candidate_count = 0;
+    state = TRANSACTION_FAILED;
+    retry_delay = TRANSACTION_RETRY_DELAY_MIN;
+    attempts.reserve(TRANSACTION_MAX_ATTEMPTS);
+}
+
+/**
+ * @brief Restart the transaction
+ *
+ * Discards the bytes received, the frames kept and the attempts recorded, and
+ * starts requesting the whole frame.
+ *
+ * @param newFrame Buffer of BUFLEN bytes where the frame is assembled
+ */
+void FrameTransaction::reset(unsigned char* newFrame) {
+    frame = newFrame;
+    memset(frame, 0, BUFLEN);
+    received = 0;
+    candidate_count = 0;
+    state = TRANSACTION_REQUEST;
+    retry_delay = TRANSACTION_RETRY_DELAY_MIN;
+    attempts.clear();
+}
+
+/**
+ * @brief Get the current state of the transaction
+ *
+ * @return TransactionState State of the transaction
+ */
+TransactionState FrameTransaction::getState() {
+    return state;
+}
+
+/**
+ * @brief Get the offset of the frame to request
+ *
+ * The station has to be asked for the block starting at the base address
+ * plus this offset.
+ *
+ * @return int Offset of the first byte still missing
+ */
+int FrameTransaction::getNextOffset() {
+    return received;
+}
+
+/**
+ * @brief Get the buffer where the answer has to be copied
+ *
+ * @return unsigned char* Position of the frame at getNextOffset()
+ */
+unsigned char* FrameTransaction::getBuffer() {
+    return frame + received;
+}
+
+/**
+ * @brief Get the space left in the buffer of getBuffer()
+ *
+ * @return int Maximum number of bytes to copy
+ */
+int FrameTransaction::getBufferSize() {
+    return BUFLEN - received;
+}
+
+/**
+ * @brief Record the result of an exchange and advance the state machine
+ *
+ * @param bytes Number of bytes copied into getBuffer()
+ * @param elapsed Time spent in the exchange
+ * @return short int Result of the execution of the function.
+ */
+short int FrameTransaction::completeAttempt(int bytes, chrono::microseconds elapsed) {
+    TransactionAttempt attempt;
+
+    if (state != TRANSACTION_REQUEST)
+        return -1;
+
+    if (bytes < 0)
+        bytes = 0;
+    if (bytes > getBufferSize())
+        bytes = getBufferSize();
+
+    attempt.offset = received;
+    attempt.received = bytes;
+    attempt.elapsed = elapsed;
+
+    received += bytes;
+
+    if (bytes == 0) {
+        attempt.outcome = ATTEMPT_EMPTY;
+    } else if (received < TRANSACTION_CHECKED_LEN) {
+        attempt.outcome = ATTEMPT_SHORT;
+    } else if (check_crc(frame)) {
+        attempt.outcome = ATTEMPT_OK;
+        state = TRANSACTION_DONE;
+    } else {
+        attempt.outcome = ATTEMPT_CRC;
+
+        // Keep the frame, dropping the oldest one if needed
+        if (candidate_count == TRANSACTION_MAX_CANDIDATES) {
+            memmove(candidates[0], candidates[1], (TRANSACTION_MAX_CANDIDATES - 1) * BUFLEN);
+            candidate_count--;
+        }
+        memcpy(candidates[candidate_count], frame, BUFLEN);
+        candidate_count++;
+
+        if (repairFrame()) {
+            attempt.outcome = ATTEMPT_REPAIRED;
+            state = TRANSACTION_DONE;
+        } else {
+            received = 0;
+        }
+    }
+
+    attempts.push_back(attempt);
+
+    #ifdef DEBUG
+    cout << "Transaction attempt " << attempts.size() << ": offset " << attempt.offset
+         << ", " << attempt.received << " bytes, outcome " << attempt.outcome
+         << ", " << attempt.elapsed.count() << " us" << endl;
+    #endif
+
+    if (state == TRANSACTION_REQUEST) {
+        if (attempts.size() >= (size_t)TRANSACTION_MAX_ATTEMPTS) {
+            state = TRANSACTION_FAILED;
+        } else if (attempts.size() > 1) {
+            retry_delay = retry_delay * 2;
+            if (retry_delay > TRANSACTION_RETRY_DELAY_MAX)
+                retry_delay = TRANSACTION_RETRY_DELAY_MAX;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Rebuild the frame from the frames with a bad CRC
+ *
+ * Each byte is taken from the value shared by the majority of the kept
+ * frames. The result is only accepted if its CRC is valid.
+ *
+ * @return true The frame was repaired
+ * @return false There are not enough frames or the result is not valid
+ */
+bool FrameTransaction::repairFrame() {
+    unsigned char voted[BUFLEN];
+
+    if (candidate_count < TRANSACTION_MAX_CANDIDATES)
+        return false;
+
+    for (int i = 0; i < BUFLEN; i++) {
+        if (candidates[1][i] == candidates[2][i])
+            voted[i] = candidates[1][i];
+        else
+            voted[i] = candidates[0][i];
+    }
+
+    if (!check_crc(voted))
+        return false;
+
+    memcpy(frame, voted, BUFLEN);
+    return true;
+}
+
+/**
+ * @brief Get the delay to wait before the next exchange
+ *
+ * @return std::chrono::milliseconds Delay before the next retry
+ */
+chrono::milliseconds FrameTransaction::getRetryDelay() {
+    if (attempts.empty())
+        return chrono::milliseconds(0);
+    return retry_delay;
+}
+
+/**
+ * @brief Get the record of the exchanges of the transaction
+ *
+ * @return const std::vector<TransactionAttempt>& Exchanges, in order
+ */
+const vector<TransactionAttempt>& FrameTransaction::getAttempts() {
+    return attempts;
+}
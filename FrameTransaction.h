@@ -0,0 +1,125 @@
+/**
+ * @file FrameTransaction.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief FrameTransaction Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The FrameTransaction object keeps the state of the read of a memory block
+ * of the station across several request/response exchanges, so a short or
+ * corrupt answer only costs the exchange needed to complete or repair it.
+ */
+
+#ifndef FRAMETRANSACTION_H
+#define FRAMETRANSACTION_H
+
+#include <chrono>
+#include <vector>
+
+#include "data_decoder.h"
+
+/// Maximum number of exchanges of a transaction.
+const int TRANSACTION_MAX_ATTEMPTS = 10;
+/// Number of complete frames with a bad CRC kept to repair the frame.
+const int TRANSACTION_MAX_CANDIDATES = 3;
+/// Number of bytes of the frame covered by the CRC, including the CRC itself.
+const int TRANSACTION_CHECKED_LEN = 34;
+/// Delay before the first retry of a transaction.
+const std::chrono::milliseconds TRANSACTION_RETRY_DELAY_MIN(20);
+/// Maximum delay between two retries of a transaction.
+const std::chrono::milliseconds TRANSACTION_RETRY_DELAY_MAX(640);
+
+/// State of a transaction.
+enum TransactionState {
+    /// The block from getNextOffset() has to be requested.
+    TRANSACTION_REQUEST,
+    /// A valid frame is available.
+    TRANSACTION_DONE,
+    /// The attempts are exhausted without a valid frame.
+    TRANSACTION_FAILED
+};
+
+/// Result of an exchange of a transaction.
+enum AttemptOutcome {
+    /// The frame was completed with a valid CRC.
+    ATTEMPT_OK,
+    /// The frame was repaired from the previous frames with a bad CRC.
+    ATTEMPT_REPAIRED,
+    /// The station did not answer.
+    ATTEMPT_EMPTY,
+    /// The answer did not complete the frame.
+    ATTEMPT_SHORT,
+    /// The frame was completed with a bad CRC.
+    ATTEMPT_CRC
+};
+
+/**
+ * @brief Record of an exchange of a transaction
+ */
+struct TransactionAttempt {
+    /// Offset of the frame requested.
+    int offset;
+    /// Number of bytes received.
+    int received;
+    /// Result of the exchange.
+    AttemptOutcome outcome;
+    /// Time spent in the exchange.
+    std::chrono::microseconds elapsed;
+};
+
+/**
+ * @brief FrameTransaction Class
+ *
+ * State machine of the read of a frame. The answers are placed in the frame
+ * by the offset they were requested for:
+ *  - When an answer is short, only the missing tail is requested again,
+ *      at the address of the first missing byte.
+ *  - When a complete frame has a bad CRC, it is kept and the whole frame is
+ *      requested again. Once three bad frames are kept, each byte is voted
+ *      between them, which repairs frames corrupted in different places.
+ *  - The delay before each retry grows while the exchanges keep failing.
+ *
+ * The transaction does not talk to the device: the session asks it for the
+ * offset to request, copies the answer into getBuffer() and reports it
+ * through completeAttempt(). The frame is assembled in place, in the buffer
+ * of the caller.
+ */
+class FrameTransaction
+{
+    /* FrameTransaction attributes */
+    protected:
+        /// Frame being assembled (buffer of BUFLEN bytes of the caller).
+        unsigned char *frame;
+        /// Number of bytes of the frame already received.
+        int received;
+        /// Complete frames received with a bad CRC.
+        unsigned char candidates[TRANSACTION_MAX_CANDIDATES][BUFLEN];
+        /// Number of frames in candidates.
+        int candidate_count;
+        /// Current state of the transaction.
+        TransactionState state;
+        /// Delay before the next retry.
+        std::chrono::milliseconds retry_delay;
+        /// Record of every exchange of the transaction.
+        std::vector<TransactionAttempt> attempts;
+
+        bool repairFrame();
+
+    /* FrameTransaction public methods */
+    public:
+        FrameTransaction();
+
+        void reset(unsigned char* newFrame);
+        TransactionState getState();
+        int getNextOffset();
+        unsigned char* getBuffer();
+        int getBufferSize();
+        short int completeAttempt(int bytes, std::chrono::microseconds elapsed);
+
+        std::chrono::milliseconds getRetryDelay();
+        const std::vector<TransactionAttempt>& getAttempts();
+};
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file HistoryReader.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief HistoryReader Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The HistoryReader object walks the history ring kept in the memory of the
+ * TE923 station, so the records stored by the station while the program was
+ * not running can be recovered.
+ */
+
+#include "HistoryReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "data_decoder.h"
+
+using namespace std;
+
+/// Bytes of a record values stored in its first block.
+const int HISTORY_FIRST_BLOCK_LEN = 11;
+/// Bytes of a record values stored in its second block.
+const int HISTORY_SECOND_BLOCK_LEN = 21;
+
+/**
+ * @brief Construct a new HistoryReader object
+ *
+ * The station is considered to be a model with the small memory.
+ *
+ * @param newSession Session with the station
+ */
+HistoryReader::HistoryReader(UsbSession *newSession) {
+    session = newSession;
+    ring_records = TE923_HISTORY_RECORDS_SMALL;
+}
+
+/**
+ * @brief Construct a new HistoryReader object
+ *
+ * @param newSession Session with the station
+ * @param newRingRecords Number of records of the ring of the station model
+ */
+HistoryReader::HistoryReader(UsbSession *newSession, int newRingRecords) {
+    session = newSession;
+    ring_records = newRingRecords;
+}
+
+/**
+ * @brief Obtain the memory address of a record of the ring
+ *
+ * @param index Position of the record in the ring
+ * @return int Memory address of the record
+ */
+int HistoryReader::recordAddress(int index) {
+    return TE923_HISTORY_START_ADDR + index * TE923_HISTORY_RECORD_SIZE;
+}
+
+/**
+ * @brief Read the position of the newest record of the ring
+ *
+ * @param index Position of the newest record
+ * @return short int Result of the execution of the function.
+ */
+short int HistoryReader::readNewestIndex(int &index) {
+    unsigned char buf[BUFLEN];
+    short int retValue;
+
+    retValue = session->readAddress(TE923_HISTORY_INDEX_ADDR, buf);
+    if (retValue < 0)
+        return retValue;
+
+    index = buf[3] * 0x100 + buf[5];
+    if (index < 0 || index >= ring_records) {
+        cerr << "Invalid history index " << index << endl;
+        return -6;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Read a record of the ring
+ *
+ * Each record needs two reads: the first block has the date and the first
+ * values, and the second block the rest of the values. The year is not
+ * stored, so it is the current one unless the month is still to come.
+ *
+ * @param index Position of the record in the ring
+ * @param record Record read
+ * @return short int 0 if the record was read, 1 if the position is empty,
+ * negative if the read failed.
+ */
+short int HistoryReader::readRecord(int index, HistoryRecord &record) {
+    unsigned char buf[BUFLEN];
+    short int retValue;
+    time_t now = time(nullptr);
+    tm now_tm = *localtime(&now);
+    tm record_tm;
+    int addr = recordAddress(index);
+
+    retValue = session->readAddress(addr, buf);
+    if (retValue < 0)
+        return retValue;
+
+    if (buf[1] == 0xFF)
+        return 1;
+
+    memset(&record_tm, 0, sizeof(record_tm));
+    record_tm.tm_mon = (buf[1] & 0x0F) - 1;
+    record_tm.tm_mday = bcd2int(buf[2]);
+    record_tm.tm_hour = bcd2int(buf[3]);
+    record_tm.tm_min = bcd2int(buf[4]);
+    record_tm.tm_year = now_tm.tm_year;
+    if (record_tm.tm_mon > now_tm.tm_mon)
+        record_tm.tm_year--;
+    record_tm.tm_isdst = -1;
+
+    if (record_tm.tm_mon < 0 || record_tm.tm_mon > 11 || record_tm.tm_mday < 1 ||
+        record_tm.tm_mday > 31 || record_tm.tm_hour > 23 || record_tm.tm_min > 59)
+        return 1;
+
+    record.timestamp = mktime(&record_tm);
+    memset(record.frame, 0, BUFLEN);
+    memcpy(record.frame, buf + 5, HISTORY_FIRST_BLOCK_LEN);
+
+    retValue = session->readAddress(addr + TE923_HISTORY_SECOND_BLOCK, buf);
+    if (retValue < 0)
+        return retValue;
+
+    memcpy(record.frame + HISTORY_FIRST_BLOCK_LEN, buf + 1, HISTORY_SECOND_BLOCK_LEN);
+
+    return 0;
+}
+
+/**
+ * @brief Dump all the records newer than a timestamp
+ *
+ * Walks the ring from the newest record backwards, until it reaches a record
+ * not newer than the timestamp, an empty position, or the whole ring was
+ * read. If any read fails nothing is returned, so the caller never stores a
+ * dump with holes.
+ *
+ * @param since Timestamp of the last record already stored
+ * @param records Records dumped, from the oldest to the newest
+ * @return int Number of records dumped, negative if the dump failed.
+ */
+int HistoryReader::dumpSince(time_t since, std::vector<HistoryRecord> &records) {
+    HistoryRecord record;
+    int index;
+    short int retValue;
+
+    records.clear();
+
+    retValue = readNewestIndex(index);
+    if (retValue < 0)
+        return retValue;
+
+    for (int i = 0; i < ring_records; i++) {
+        retValue = readRecord(index, record);
+        if (retValue < 0) {
+            records.clear();
+            return retValue;
+        }
+        if (retValue > 0 || record.timestamp <= since)
+            break;
+
+        records.push_back(record);
+        index = (index == 0) ? ring_records - 1 : index - 1;
+    }
+
+    reverse(records.begin(), records.end());
+
+    return records.size();
+}
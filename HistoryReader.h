@@ -0,0 +1,78 @@
+/**
+ * @file HistoryReader.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief HistoryReader Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The HistoryReader object walks the history ring kept in the memory of the
+ * TE923 station, so the records stored by the station while the program was
+ * not running can be recovered.
+ */
+
+#ifndef HISTORYREADER_H
+#define HISTORYREADER_H
+
+#include <ctime>
+#include <vector>
+
+#include "data_decoder.h"
+#include "UsbSession.h"
+
+/// Memory address of the history ring index.
+const int TE923_HISTORY_INDEX_ADDR = 0xFB;
+/// Memory address of the first record of the history ring.
+const int TE923_HISTORY_START_ADDR = 0x101;
+/// Size in bytes of each record of the history ring.
+const int TE923_HISTORY_RECORD_SIZE = 0x26;
+/// Offset of the second block of a record, read apart.
+const int TE923_HISTORY_SECOND_BLOCK = 0x10;
+/// Records of the history ring in the models with the small memory.
+const int TE923_HISTORY_RECORDS_SMALL = 208;
+/// Records of the history ring in the models with the large memory.
+const int TE923_HISTORY_RECORDS_LARGE = 3442;
+
+/**
+ * @brief Record of the history ring of the station
+ *
+ * The values are stored with the same layout as the current readings frame,
+ * so they can be decoded with the same functions.
+ */
+struct HistoryRecord {
+    /// Timestamp of the record, from the station clock.
+    time_t timestamp;
+    /// Values of the record, laid out as a current readings frame.
+    unsigned char frame[BUFLEN];
+};
+
+/**
+ * @brief HistoryReader Class
+ *
+ * Reads the history ring of a station through an opened UsbSession. The ring
+ * is walked from the newest record backwards, so a dump can stop as soon as
+ * it reaches the records already stored.
+ */
+class HistoryReader
+{
+    /* HistoryReader attributes */
+    protected:
+        /// Session with the station.
+        UsbSession *session;
+        /// Number of records of the ring of the station model.
+        int ring_records;
+
+        int recordAddress(int index);
+
+    /* HistoryReader public methods */
+    public:
+        HistoryReader(UsbSession *newSession);
+        HistoryReader(UsbSession *newSession, int newRingRecords);
+
+        short int readNewestIndex(int &index);
+        short int readRecord(int index, HistoryRecord &record);
+        int dumpSince(time_t since, std::vector<HistoryRecord> &records);
+};
+
+#endif
@@ -13,6 +13,7 @@
  */
 
 #include "Observation.h"
+#include "derived_values.h"
 #include <ctime>
 #include <iostream>
 #include <list>
@@ -31,9 +32,14 @@ Observation::Observation() {
 	timestamp = std::time(nullptr);
 	pressure = 1013;
 	rainfall = 0;
+	uv_index = 0;
+	valid_fields = 0;
+	field_status = 0;
 
-    temperature[0] = 0.0; temperature[1] = 0.0; temperature[2] = 0.0;
-    humidity[0] = 0.0; humidity[1] = 0.0; humidity[2] = 0.0;
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i] = 0.0;
+        humidity[i] = 0.0;
+    }
     wind_chill = 0.0;
     wind_gust = 0.0;
     wind_dir = 0;
@@ -53,12 +59,46 @@ Observation::Observation(unsigned int newTimestamp){
 	timestamp = newTimestamp;
 	pressure = 1013;
 	rainfall = 0;
+	uv_index = 0;
+	valid_fields = 0;
+	field_status = 0;
+
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i] = 0.0;
+        humidity[i] = 0.0;
+    }
+    wind_chill = 0.0;
+    wind_gust = 0.0;
+    wind_dir = 0;
+}
+
+/**
+ * @brief Reset the Observation to its initial values
+ * 
+ * Used to reuse an Observation for a new measurement. The storage of the
+ * station identifier is kept, so it is not allocated again.
+ * 
+ * @param newTimestamp Timestamp to assign to the Observation.
+ */
+void Observation::clear(unsigned int newTimestamp) {
+	timestamp = newTimestamp;
+	pressure = 1013;
+	rainfall = 0;
+	uv_index = 0;
+	valid_fields = 0;
+	field_status = 0;
 
-    temperature[0] = 0.0; temperature[1] = 0.0; temperature[2] = 0.0;
-    humidity[0] = 0.0; humidity[1] = 0.0; humidity[2] = 0.0;
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i] = 0.0;
+        humidity[i] = 0.0;
+    }
     wind_chill = 0.0;
     wind_gust = 0.0;
+    wind_speed = 0.0;
     wind_dir = 0;
+    dew_point = 0.0;
+    real_feel = 0.0;
+    station_id.clear();
 }
 
 /**
@@ -66,7 +106,7 @@ Observation::Observation(unsigned int newTimestamp){
  * 
  * @return unsigned int Current timestamp of the Observation
  */
-unsigned int Observation::getTimestamp() {
+unsigned int Observation::getTimestamp() const {
     return timestamp;
 }
 
@@ -85,7 +125,7 @@ void Observation::setTimestamp(unsigned int newTimestamp) {
  * @param pos Identifier of the temperature to obtain
  * @return float Value of the temperature selected
  */
-float Observation::getTemperature(int pos) {
+float Observation::getTemperature(int pos) const {
     return temperature[pos];
 }
 
@@ -105,7 +145,7 @@ void Observation::setTemperature(float newTemperature, int pos) {
  * @param pos Identifier of the humidity to obtain
  * @return float Value of the humidity selected
  */
-float Observation::getHumidity(int pos) {
+float Observation::getHumidity(int pos) const {
     return humidity[pos];
 }
 
@@ -124,7 +164,7 @@ void Observation::setHumidity(float newHumidity, int pos) {
  * 
  * @return float Value of the pressure
  */
-float Observation::getPressure() {
+float Observation::getPressure() const {
     return pressure;
 }
 
@@ -142,7 +182,7 @@ void Observation::setPressure(float newPressure) {
  * 
  * @return float Value of the wind chill
  */
-float Observation::getWindChill()
+float Observation::getWindChill() const
 {
     return wind_chill;
 }
@@ -162,7 +202,7 @@ void Observation::setWindChill(float newWindChill)
  * 
  * @return float Value of the wind gust
  */
-float Observation::getWindGust() {
+float Observation::getWindGust() const {
     return wind_gust;
 }
 
@@ -180,7 +220,7 @@ void Observation::setWindGust(float newWindGust) {
  * 
  * @return float Value of the wind speed
  */
-float Observation::getWindSpeed()
+float Observation::getWindSpeed() const
 {
     return wind_speed;
 }
@@ -200,7 +240,7 @@ void Observation::setWindSpeed(float newWindSpeed)
  * 
  * @return float Value of the wind direction
  */
-float Observation::getWindDir() {
+float Observation::getWindDir() const {
     return wind_dir;
 }
 
@@ -218,7 +258,7 @@ void Observation::setWindDir(float newWindDir) {
  * 
  * @return float Value of the rainfall
  */
-float Observation::getRainfall() {
+float Observation::getRainfall() const {
     return rainfall;
 }
 
@@ -231,12 +271,66 @@ void Observation::setRainfall(float newRainfall) {
     rainfall = newRainfall;
 }
 
+/**
+ * @brief Get the value of the UV index attribute
+ * 
+ * @return float Value of the UV index
+ */
+float Observation::getUVIndex() const {
+    return uv_index;
+}
+
+/**
+ * @brief Set the value of the UV index attribute
+ * 
+ * @param newUVIndex New value of the UV index
+ */
+void Observation::setUVIndex(float newUVIndex) {
+    uv_index = newUVIndex;
+}
+
+/**
+ * @brief Get the flags of the values available
+ * 
+ * @return uint32_t DECODED_* flags of the values available in the frame
+ */
+uint32_t Observation::getValidFields() const {
+    return valid_fields;
+}
+
+/**
+ * @brief Set the flags of the values available
+ * 
+ * @param newValidFields DECODED_* flags of the values available in the frame
+ */
+void Observation::setValidFields(uint32_t newValidFields) {
+    valid_fields = newValidFields;
+}
+
+/**
+ * @brief Get the status of each value
+ * 
+ * @return uint64_t FieldStatus of each value, as DecodedFrame::status
+ */
+uint64_t Observation::getFieldStatus() const {
+    return field_status;
+}
+
+/**
+ * @brief Set the status of each value
+ * 
+ * @param newFieldStatus FieldStatus of each value, as DecodedFrame::status
+ */
+void Observation::setFieldStatus(uint64_t newFieldStatus) {
+    field_status = newFieldStatus;
+}
+
 /**
  * @brief Get the value of the dew point attribute
  * 
  * @return float Value of the dew point
  */
-float Observation::getDewPoint()
+float Observation::getDewPoint() const
 {
     return dew_point;
 }
@@ -256,7 +350,7 @@ void Observation::setDewPoint(float newDewPoint)
  * 
  * @return float Value of the RealFeel
  */
-float Observation::getRealFeel()
+float Observation::getRealFeel() const
 {
     return real_feel;
 }
@@ -271,26 +365,41 @@ void Observation::setRealFeel(float newRealFeel)
     real_feel = newRealFeel;
 }
 
+/**
+ * @brief Get the identifier of the station of the Observation
+ * 
+ * @return const std::string& Identifier of the station (bus-port path)
+ */
+const std::string& Observation::getStationId() const
+{
+    return station_id;
+}
+
+/**
+ * @brief Set the identifier of the station of the Observation
+ * 
+ * @param newStationId Identifier of the station (bus-port path)
+ */
+void Observation::setStationId(const std::string& newStationId)
+{
+    station_id = newStationId;
+}
+
 /**
  * @brief Calculation of the dew point
  * 
  * From the current temperature and humidity attributes already present in the
- * Observation, the associated dew point is calculated.
+ * Observation, the associated dew point is calculated (with
+ * calculate_dew_point(), which avoids the pow() of the formula).
  * 
  * @return short int If the calculated value is valid.
  */
 short int Observation::calculateDewPoint()
 {
-    float f_dew_point;
-
     if (humidity[1] == 0.0 & temperature[1] == 0.0)
         return -1;
 
-    f_dew_point = pow(humidity[1]/100, 0.125);
-    f_dew_point *= (112 + (0.9*temperature[1]));
-    f_dew_point -= 112;
-
-    dew_point = f_dew_point;
+    dew_point = calculate_dew_point(temperature[1], humidity[1]);
     return 0;
 }
 
@@ -299,105 +408,21 @@ short int Observation::calculateDewPoint()
  * 
  * From the different attributes of an Observation, and following the original
  * patent function, calculates the RealFeel value associate to an Observation
+ * (with calculate_real_feel(), which follows the steps of the patent without
+ * branches). The dew point is calculated again.
  * 
  * Note: currently the Rain Index (RI1 & RI2) are 0.
  * 
- * TODO: Introduce an external UV value to the formulae.
- * 
  * @param uv_index UV index externally calculated
- * @return short int 
+ * @return short int If the calculated value is valid.
  */
 short int Observation::calculateRealFeel(int uv_index)
 {
-    float temp1_f;
-    float wind_speed_mph;
-    float dew_point1_f;
-    float MFT;
-
     if (humidity[1] == 0.0 & temperature[1] == 0.0)
         return -1;
 
     calculateDewPoint();
 
-    // Initial conversions
-    temp1_f = ((temperature[1]*9) / 5) + 32;
-    wind_speed_mph = wind_speed / 1,609;
-    dew_point1_f = ((dew_point*9) / 5) + 32;
-
-    // Step 205. Separate ways depending on T1.
-    
-    if (temp1_f > 65)
-    {
-        // Step 210. Calculation of WSP2
-        float WSP2, SI2, H2, P2;
-
-        float w_a;
-        if (wind_speed_mph < 4)
-        {
-            w_a = wind_speed_mph/2 + 2;
-        }
-        else if (wind_speed_mph > 56)
-        {
-            w_a = 56.0;
-        }
-        else
-        {
-            w_a = wind_speed_mph;
-        }
-        
-        WSP2 = (80 - temp1_f) * (0.566 + 0.25*sqrt(w_a) - 0.0166 * w_a) * (sqrt(pressure/10)/10);
-
-        // Step 220. Calculation of SI2
-        SI2 = uv_index;
-
-        // Step 230. Calculation of H2
-        float d_a;
-        if (dew_point1_f >= (55+sqrt(wind_speed_mph)))
-        {
-            d_a = dew_point1_f;
-        }
-        else
-        {
-            d_a = 55 + sqrt(wind_speed_mph);
-        }
-        
-        H2 = pow((d_a - 55 - sqrt(wind_speed_mph)), 2) / 30;
-
-        // Step 240. Calculation of P2
-        P2 = 0;
-
-        // Step 250. Calculation of MFT
-        MFT = 80 - WSP2 + SI2 + H2 - P2;
-    }
-    else
-    {
-        // Step 215. Calculation of WSP1
-        float WSP1, SI1, H1, P1;
-
-        WSP1 = sqrt(wind_speed_mph) * (sqrt(pressure/10)/10);
-
-        // Step 225. Calculation of SI1
-        SI1 = uv_index;
-
-        // Step 235. Calculation of H1
-        float d_a;
-        if (dew_point1_f >= (55+sqrt(wind_speed_mph)))
-        {
-            d_a = dew_point1_f;
-        }
-        else
-        {
-            d_a = 55 + sqrt(wind_speed_mph);
-        }
-        
-        H1 = pow((d_a - 55 - sqrt(wind_speed_mph)), 2) / 30;
-
-        // Step 245. Calculation of P1
-        P1 = 0;
-
-        // Step 255. Calculation of MFT
-        MFT = temp1_f - WSP1 + SI1 + H1 - P1;
-    }
-
-    real_feel = ((MFT - 32) * 5) / 9;
-}
\ No newline at end of file
+    real_feel = calculate_real_feel(temperature[1], dew_point, wind_speed, pressure, uv_index);
+    return 0;
+}
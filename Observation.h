@@ -12,7 +12,15 @@
  * object in the application.
  */
 
+#ifndef OBSERVATION_H
+#define OBSERVATION_H
+
+#include <cstdint>
 #include <list>
+#include <string>
+
+/// Number of temperature and humidity channels of an Observation.
+const int OBSERVATION_CHANNELS = 6;
 
 /**
  * @brief Observation Class
@@ -27,10 +35,10 @@ class Observation
     protected:
         /// Timestamp of when the observation is made.
         unsigned int timestamp;
-        /// Temperatures of the three different sensors.
-        float temperature[3];
-        /// Humidity of the three different sensors.
-        float humidity[3];
+        /// Temperatures of the channels (0 is the indoor one).
+        float temperature[OBSERVATION_CHANNELS];
+        /// Humidity of the channels (0 is the indoor one).
+        float humidity[OBSERVATION_CHANNELS];
         /// Pressure in mb.
         float pressure;
         /// Wind chill in kmh (calculated in devide)
@@ -41,54 +49,79 @@ class Observation
         float wind_speed;
         /// Wind direction (only 16 possible options)
         float wind_dir;
-        /// Accumulated rain (0 by now)
+        /// Accumulated rain in mm, since the station was reset
         float rainfall;
+        /// UV index, from the station or from the UV API
+        float uv_index;
+        /// Flags of the values available in the frame (DECODED_* of data_decoder.h)
+        uint32_t valid_fields;
+        /// FieldStatus of each value of the frame (DecodedFrame::status of data_decoder.h)
+        uint64_t field_status;
 
         /// Calculated dew point of an Observation.
         float dew_point;
         /// Calculated RealFeel© value of an Observation.
         float real_feel;
 
+        /// Identifier of the station that made the observation.
+        std::string station_id;
+
     /* Observation public methods */
     public:
 		Observation();
 		Observation(unsigned int newTimestamp);
+
+        void clear(unsigned int newTimestamp = 0);
 		
-        unsigned int getTimestamp();
+        unsigned int getTimestamp() const;
         void setTimestamp(unsigned int newTimestamp);
 
-        float getTemperature(int pos);
+        float getTemperature(int pos) const;
         void setTemperature(float newTemperature, int pos);
         //void setTemperature(std::list<float> new_temps);
 
-        float getHumidity(int pos);
+        float getHumidity(int pos) const;
         void setHumidity(float newHumidity, int pos);
         //void setHumidity(std::list<float> new_temps);
 
-        float getPressure();
+        float getPressure() const;
         void setPressure(float newPressure);
 
-        float getWindChill();
+        float getWindChill() const;
         void setWindChill(float newWindChill);
 
-        float getWindGust();
+        float getWindGust() const;
         void setWindGust(float newWindGust);
 
-        float getWindSpeed();
+        float getWindSpeed() const;
         void setWindSpeed(float newWindSpeed);
 
-        float getWindDir();
+        float getWindDir() const;
         void setWindDir(float newWindDir);
 
-        float getRainfall();
+        float getRainfall() const;
         void setRainfall(float newRainfall);
 
-        float getDewPoint();
+        float getUVIndex() const;
+        void setUVIndex(float newUVIndex);
+
+        uint32_t getValidFields() const;
+        void setValidFields(uint32_t newValidFields);
+
+        uint64_t getFieldStatus() const;
+        void setFieldStatus(uint64_t newFieldStatus);
+
+        float getDewPoint() const;
         void setDewPoint(float newDewPoint);
 
-        float getRealFeel();
+        float getRealFeel() const;
         void setRealFeel(float newRealFeel);
 
+        const std::string& getStationId() const;
+        void setStationId(const std::string& newStationId);
+
         short int calculateDewPoint();
         short int calculateRealFeel(int uv_index);
-};
\ No newline at end of file
+};
+
+#endif
@@ -0,0 +1,393 @@
+/**
+ * @file ObservationBatch.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief ObservationBatch Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Columnar store of many Observations of a station, for the backfills, the
+ * replays and the aggregations, where the derived values of thousands of
+ * Observations are calculated together.
+ *
+ * The dew point and the RealFeel© are calculated by the batch kernels of
+ * derived_values.h, straight on the columns.
+ */
+
+#include "ObservationBatch.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "derived_values.h"
+
+using namespace std;
+
+/// Number of columns of 4 bytes of an ObservationBatch.
+const int OBSERVATION_BATCH_COLUMNS = 2 * OBSERVATION_CHANNELS + 11;
+/// Number of columns of 8 bytes of an ObservationBatch, after the others.
+const int OBSERVATION_BATCH_WIDE_COLUMNS = 1;
+
+/**
+ * @brief Construct a new, empty ObservationBatch
+ */
+ObservationBatch::ObservationBatch()
+{
+    count = 0;
+    capacity = 0;
+    storage = NULL;
+    timestamp = NULL;
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i] = NULL;
+        humidity[i] = NULL;
+    }
+    pressure = NULL;
+    wind_chill = NULL;
+    wind_gust = NULL;
+    wind_speed = NULL;
+    wind_dir = NULL;
+    rainfall = NULL;
+    uv_index = NULL;
+    valid_fields = NULL;
+    field_status = NULL;
+    dew_point = NULL;
+    real_feel = NULL;
+}
+
+/**
+ * @brief Construct a new, empty ObservationBatch with room for some Observations
+ *
+ * @param newCapacity Number of Observations that fit without reallocating
+ */
+ObservationBatch::ObservationBatch(size_t newCapacity) : ObservationBatch()
+{
+    reserve(newCapacity);
+}
+
+/**
+ * @brief Destroy the ObservationBatch object
+ */
+ObservationBatch::~ObservationBatch()
+{
+    free(storage);
+}
+
+/**
+ * @brief Get the number of Observations of the batch
+ *
+ * @return size_t Number of Observations
+ */
+size_t ObservationBatch::size() const
+{
+    return count;
+}
+
+/**
+ * @brief Get the number of Observations that fit without reallocating
+ *
+ * @return size_t Capacity of the columns
+ */
+size_t ObservationBatch::getCapacity() const
+{
+    return capacity;
+}
+
+/**
+ * @brief Make room for some Observations
+ *
+ * The columns are moved to a new block of memory, which invalidates the
+ * pointers returned by the getters. Throws bad_alloc if there is no memory.
+ *
+ * @param newCapacity Number of Observations that have to fit
+ */
+void ObservationBatch::reserve(size_t newCapacity)
+{
+    const size_t block = OBSERVATION_BATCH_ALIGNMENT / sizeof(float);
+    unsigned char* old_storage = storage;
+    unsigned char* columns[OBSERVATION_BATCH_COLUMNS];
+    unsigned char* old_columns[OBSERVATION_BATCH_COLUMNS];
+    uint64_t* old_field_status = field_status;
+    void* memory;
+    size_t stride;
+    int c = 0;
+
+    if (newCapacity <= capacity)
+        return;
+
+    // Every column starts aligned, and its end is padded to a whole vector
+    newCapacity = (newCapacity + block - 1) / block * block;
+    stride = newCapacity * sizeof(float);
+    if (posix_memalign(&memory, OBSERVATION_BATCH_ALIGNMENT,
+                       stride * (OBSERVATION_BATCH_COLUMNS + 2 * OBSERVATION_BATCH_WIDE_COLUMNS)) != 0)
+        throw bad_alloc();
+    storage = (unsigned char*)memory;
+
+    old_columns[c++] = (unsigned char*)timestamp;
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        old_columns[c++] = (unsigned char*)temperature[i];
+        old_columns[c++] = (unsigned char*)humidity[i];
+    }
+    old_columns[c++] = (unsigned char*)pressure;
+    old_columns[c++] = (unsigned char*)wind_chill;
+    old_columns[c++] = (unsigned char*)wind_gust;
+    old_columns[c++] = (unsigned char*)wind_speed;
+    old_columns[c++] = (unsigned char*)wind_dir;
+    old_columns[c++] = (unsigned char*)rainfall;
+    old_columns[c++] = (unsigned char*)uv_index;
+    old_columns[c++] = (unsigned char*)valid_fields;
+    old_columns[c++] = (unsigned char*)dew_point;
+    old_columns[c++] = (unsigned char*)real_feel;
+
+    for (c = 0; c < OBSERVATION_BATCH_COLUMNS; c++) {
+        columns[c] = storage + c * stride;
+        memset(columns[c], 0, stride);
+        if (count > 0)
+            memcpy(columns[c], old_columns[c], count * sizeof(float));
+    }
+
+    c = 0;
+    timestamp = (unsigned int*)columns[c++];
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i] = (float*)columns[c++];
+        humidity[i] = (float*)columns[c++];
+    }
+    pressure = (float*)columns[c++];
+    wind_chill = (float*)columns[c++];
+    wind_gust = (float*)columns[c++];
+    wind_speed = (float*)columns[c++];
+    wind_dir = (float*)columns[c++];
+    rainfall = (float*)columns[c++];
+    uv_index = (float*)columns[c++];
+    valid_fields = (uint32_t*)columns[c++];
+    dew_point = (float*)columns[c++];
+    real_feel = (float*)columns[c++];
+
+    field_status = (uint64_t*)(storage + OBSERVATION_BATCH_COLUMNS * stride);
+    memset(field_status, 0, newCapacity * sizeof(uint64_t));
+    if (count > 0)
+        memcpy(field_status, old_field_status, count * sizeof(uint64_t));
+
+    capacity = newCapacity;
+    free(old_storage);
+}
+
+/**
+ * @brief Remove every Observation, keeping the memory
+ */
+void ObservationBatch::clear()
+{
+    count = 0;
+}
+
+/**
+ * @brief Add an Observation at the end of the batch
+ *
+ * @param obs Observation to add
+ */
+void ObservationBatch::push_back(const Observation& obs)
+{
+    if (count == capacity)
+        reserve(capacity == 0 ? OBSERVATION_BATCH_INITIAL_CAPACITY : capacity * 2);
+
+    timestamp[count] = obs.getTimestamp();
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i][count] = obs.getTemperature(i);
+        humidity[i][count] = obs.getHumidity(i);
+    }
+    pressure[count] = obs.getPressure();
+    wind_chill[count] = obs.getWindChill();
+    wind_gust[count] = obs.getWindGust();
+    wind_speed[count] = obs.getWindSpeed();
+    wind_dir[count] = obs.getWindDir();
+    rainfall[count] = obs.getRainfall();
+    uv_index[count] = obs.getUVIndex();
+    valid_fields[count] = obs.getValidFields();
+    field_status[count] = obs.getFieldStatus();
+    dew_point[count] = obs.getDewPoint();
+    real_feel[count] = obs.getRealFeel();
+    count++;
+}
+
+/**
+ * @brief Copy an Observation of the batch
+ *
+ * The station identifier of the Observation is kept.
+ *
+ * @param index Position of the Observation in the batch
+ * @param obs Observation to fill
+ */
+void ObservationBatch::getObservation(size_t index, Observation& obs) const
+{
+    obs.setTimestamp(timestamp[index]);
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        obs.setTemperature(temperature[i][index], i);
+        obs.setHumidity(humidity[i][index], i);
+    }
+    obs.setPressure(pressure[index]);
+    obs.setWindChill(wind_chill[index]);
+    obs.setWindGust(wind_gust[index]);
+    obs.setWindSpeed(wind_speed[index]);
+    obs.setWindDir(wind_dir[index]);
+    obs.setRainfall(rainfall[index]);
+    obs.setUVIndex(uv_index[index]);
+    obs.setValidFields(valid_fields[index]);
+    obs.setFieldStatus(field_status[index]);
+    obs.setDewPoint(dew_point[index]);
+    obs.setRealFeel(real_feel[index]);
+}
+
+/**
+ * @brief Get the column of the timestamps
+ *
+ * @return const unsigned int* Timestamp of each Observation
+ */
+const unsigned int* ObservationBatch::getTimestamps() const {
+    return timestamp;
+}
+
+/**
+ * @brief Get the column of the temperatures of a channel
+ *
+ * @param pos Channel of the temperatures
+ * @return const float* Temperature of each Observation
+ */
+const float* ObservationBatch::getTemperatures(int pos) const {
+    return temperature[pos];
+}
+
+/**
+ * @brief Get the column of the humidities of a channel
+ *
+ * @param pos Channel of the humidities
+ * @return const float* Humidity of each Observation
+ */
+const float* ObservationBatch::getHumidities(int pos) const {
+    return humidity[pos];
+}
+
+/**
+ * @brief Get the column of the pressures
+ *
+ * @return const float* Pressure of each Observation
+ */
+const float* ObservationBatch::getPressures() const {
+    return pressure;
+}
+
+/**
+ * @brief Get the column of the wind chills
+ *
+ * @return const float* Wind chill of each Observation
+ */
+const float* ObservationBatch::getWindChills() const {
+    return wind_chill;
+}
+
+/**
+ * @brief Get the column of the wind gusts
+ *
+ * @return const float* Wind gust of each Observation
+ */
+const float* ObservationBatch::getWindGusts() const {
+    return wind_gust;
+}
+
+/**
+ * @brief Get the column of the wind speeds
+ *
+ * @return const float* Wind speed of each Observation
+ */
+const float* ObservationBatch::getWindSpeeds() const {
+    return wind_speed;
+}
+
+/**
+ * @brief Get the column of the wind directions
+ *
+ * @return const float* Wind direction of each Observation
+ */
+const float* ObservationBatch::getWindDirs() const {
+    return wind_dir;
+}
+
+/**
+ * @brief Get the column of the accumulated rain
+ *
+ * @return const float* Rainfall of each Observation
+ */
+const float* ObservationBatch::getRainfalls() const {
+    return rainfall;
+}
+
+/**
+ * @brief Get the column of the UV indexes
+ *
+ * @return const float* UV index of each Observation
+ */
+const float* ObservationBatch::getUVIndexes() const {
+    return uv_index;
+}
+
+/**
+ * @brief Get the column of the flags of the values available
+ *
+ * @return const uint32_t* Valid fields of each Observation
+ */
+const uint32_t* ObservationBatch::getValidFields() const {
+    return valid_fields;
+}
+
+/**
+ * @brief Get the column of the statuses of the values
+ *
+ * @return const uint64_t* FieldStatus of each value of each Observation
+ */
+const uint64_t* ObservationBatch::getFieldStatuses() const {
+    return field_status;
+}
+
+/**
+ * @brief Get the column of the dew points
+ *
+ * @return const float* Dew point of each Observation
+ */
+const float* ObservationBatch::getDewPoints() const {
+    return dew_point;
+}
+
+/**
+ * @brief Get the column of the RealFeel© values
+ *
+ * @return const float* RealFeel© of each Observation
+ */
+const float* ObservationBatch::getRealFeels() const {
+    return real_feel;
+}
+
+/**
+ * @brief Calculation of the dew point of every Observation
+ *
+ * Same as Observation::calculateDewPoint(), within
+ * BATCH_DEW_POINT_TOLERANCE. The Observations with the temperature and the
+ * humidity of the channel 1 at 0 keep their dew point.
+ */
+void ObservationBatch::calculateDewPoint()
+{
+    calculate_dew_points(temperature[1], humidity[1], dew_point, count);
+}
+
+/**
+ * @brief Calculation of the RealFeel© value of every Observation
+ *
+ * Same as Observation::calculateRealFeel() with the UV index of each
+ * Observation rounded (as process_frame() does), within
+ * BATCH_REAL_FEEL_TOLERANCE. The dew points are calculated too. The
+ * Observations with the temperature and the humidity of the channel 1 at 0
+ * keep both values.
+ */
+void ObservationBatch::calculateRealFeel()
+{
+    calculate_real_feels(temperature[1], humidity[1], wind_speed, pressure, uv_index, dew_point, real_feel, count);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file ObservationBatch.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief ObservationBatch Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Columnar store of many Observations of a station, for the backfills, the
+ * replays and the aggregations, where the derived values of thousands of
+ * Observations are calculated together.
+ */
+
+#ifndef OBSERVATIONBATCH_H
+#define OBSERVATIONBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Observation.h"
+
+/// Alignment of the columns of an ObservationBatch, in bytes.
+const size_t OBSERVATION_BATCH_ALIGNMENT = 64;
+/// Number of Observations that fit in an ObservationBatch when it first grows.
+const size_t OBSERVATION_BATCH_INITIAL_CAPACITY = 64;
+
+/**
+ * @brief ObservationBatch Class
+ *
+ * Keeps each value of the Observations in its own array (structure of
+ * arrays), aligned to OBSERVATION_BATCH_ALIGNMENT, so the dew point and the
+ * RealFeel© of the whole batch are calculated by the SIMD kernels of
+ * derived_values.h (SSE2, or AVX when built with -mavx or -mavx2), which
+ * differ from the methods of Observation by rounding (see
+ * BATCH_DEW_POINT_TOLERANCE and BATCH_REAL_FEEL_TOLERANCE).
+ * The station identifier is not kept (a batch has the Observations of one
+ * station).
+ */
+class ObservationBatch
+{
+    /* ObservationBatch attributes */
+    protected:
+        /// Number of Observations in the batch.
+        size_t count;
+        /// Number of Observations that fit in the columns.
+        size_t capacity;
+        /// Memory of all the columns.
+        unsigned char* storage;
+
+        /// Timestamps of the Observations.
+        unsigned int* timestamp;
+        /// Temperatures of each channel.
+        float* temperature[OBSERVATION_CHANNELS];
+        /// Humidities of each channel.
+        float* humidity[OBSERVATION_CHANNELS];
+        /// Pressures in mb.
+        float* pressure;
+        /// Wind chills.
+        float* wind_chill;
+        /// Wind gusts in kmh.
+        float* wind_gust;
+        /// Wind speeds in kmh.
+        float* wind_speed;
+        /// Wind directions.
+        float* wind_dir;
+        /// Accumulated rain in mm.
+        float* rainfall;
+        /// UV indexes.
+        float* uv_index;
+        /// Flags of the values available in the frames.
+        uint32_t* valid_fields;
+        /// Statuses of the values in the frames (DecodedFrame::status).
+        uint64_t* field_status;
+        /// Calculated dew points.
+        float* dew_point;
+        /// Calculated RealFeel© values.
+        float* real_feel;
+
+    /* ObservationBatch public methods */
+    public:
+        ObservationBatch();
+        explicit ObservationBatch(size_t newCapacity);
+        ~ObservationBatch();
+
+        ObservationBatch(const ObservationBatch&) = delete;
+        ObservationBatch& operator=(const ObservationBatch&) = delete;
+
+        size_t size() const;
+        size_t getCapacity() const;
+        void reserve(size_t newCapacity);
+        void clear();
+
+        void push_back(const Observation& obs);
+        void getObservation(size_t index, Observation& obs) const;
+
+        const unsigned int* getTimestamps() const;
+        const float* getTemperatures(int pos) const;
+        const float* getHumidities(int pos) const;
+        const float* getPressures() const;
+        const float* getWindChills() const;
+        const float* getWindGusts() const;
+        const float* getWindSpeeds() const;
+        const float* getWindDirs() const;
+        const float* getRainfalls() const;
+        const float* getUVIndexes() const;
+        const uint32_t* getValidFields() const;
+        const uint64_t* getFieldStatuses() const;
+        const float* getDewPoints() const;
+        const float* getRealFeels() const;
+
+        void calculateDewPoint();
+        void calculateRealFeel();
+};
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * @file ObservationWriter.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief ObservationWriter Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The ObservationWriter object stores the observations of a station from its
+ * own thread, so a slow DB does not delay the next acquisition.
+ */
+
+#include "ObservationWriter.h"
+
+#include <chrono>
+#include <list>
+
+#include "logger.h"
+
+using namespace std;
+
+/// Longest sleep of a writer thread without being notified.
+const chrono::milliseconds OBSERVATION_WRITER_IDLE(1000);
+
+/// Protects the writers list.
+static mutex writers_lock;
+/// Every writer created, for the diagnostics.
+static list<ObservationWriter*> writers;
+
+/**
+ * @brief Construct a new ObservationWriter object
+ *
+ * The writer thread is not started until start() is called.
+ *
+ * @param newStationId Identifier of the station of the observations
+ * @param newSink Function that stores each observation
+ */
+ObservationWriter::ObservationWriter(const std::string& newStationId, ObservationSink newSink) {
+    station_id = newStationId;
+    sink = newSink;
+    running = false;
+    waiting = false;
+    blocked = false;
+    wait_for_space = false;
+    published = 0;
+    lost = false;
+    written = 0;
+    failed = 0;
+
+    lock_guard<mutex> guard(writers_lock);
+    writers.push_back(this);
+}
+
+/**
+ * @brief Destroy the ObservationWriter object, storing the pending observations
+ */
+ObservationWriter::~ObservationWriter() {
+    stop();
+
+    lock_guard<mutex> guard(writers_lock);
+    writers.remove(this);
+}
+
+/**
+ * @brief Start the writer thread
+ */
+void ObservationWriter::start() {
+    if (running)
+        return;
+    running = true;
+    writer_thread = thread(&ObservationWriter::run, this);
+}
+
+/**
+ * @brief Stop the writer thread, once the pending observations are stored
+ *
+ * It has to be called after the last publish().
+ */
+void ObservationWriter::stop() {
+    {
+        lock_guard<mutex> guard(wake_lock);
+        running = false;
+        wake_cv.notify_all();
+        space_cv.notify_all();
+    }
+    if (writer_thread.joinable())
+        writer_thread.join();
+}
+
+/**
+ * @brief Queue an observation to be stored (from the acquisition thread only)
+ *
+ * The observation is copied, so it can be reused as soon as this returns.
+ * If the writer thread is not running, it is stored before returning.
+ *
+ * @param obs Observation to store
+ * @return short int 0 if the observation was queued or stored, negative if
+ * it was dropped, it could not be stored or a previous one could not be
+ * stored.
+ */
+short int ObservationWriter::publish(const Observation& obs) {
+    PackedObservation record;
+    bool queued;
+
+    if (wait_for_space && running)
+        waitForWriter([this]{ return queue.size() < queue.capacity(); });
+    if (!running) {
+        published++;
+        return store(obs);
+    }
+
+    record.pack(obs);
+    queued = queue.push(record);
+    if (queued)
+        published++;
+
+    /* Wake the writer thread if it sleeps (it checks the ring after setting waiting) */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (queued && waiting.load(memory_order_relaxed)) {
+        lock_guard<mutex> guard(wake_lock);
+        wake_cv.notify_one();
+    }
+
+    if (!queued) {
+        LOG_WARNING("Observation queue of %s full, observation dropped", station_id.c_str());
+        return -1;
+    }
+    return lost.exchange(false) ? -1 : 0;
+}
+
+/**
+ * @brief Make publish() wait for space in the ring when it is full
+ *
+ * Used while the station history is recovered, when the records come faster
+ * than the sink stores them.
+ *
+ * @param newWaitForSpace True to wait, false to drop the observations
+ */
+void ObservationWriter::setWaitForSpace(bool newWaitForSpace) {
+    wait_for_space = newWaitForSpace;
+}
+
+/**
+ * @brief Wait until every observation published has been stored or has
+ * failed (from the acquisition thread only)
+ */
+void ObservationWriter::flush() {
+    waitForWriter([this]{
+        return written.load(memory_order_relaxed) + failed.load(memory_order_relaxed) == published;
+    });
+}
+
+/**
+ * @brief Sleep the acquisition thread until done() or the writer stops
+ *
+ * The writer thread notifies space_cv after each observation while blocked
+ * is set.
+ *
+ * @param done Condition to wait for
+ */
+void ObservationWriter::waitForWriter(std::function<bool()> done) {
+    unique_lock<mutex> guard(wake_lock);
+    blocked = true;
+    atomic_thread_fence(memory_order_seq_cst);
+    space_cv.wait(guard, [this, &done]{ return done() || !running; });
+    blocked = false;
+}
+
+/**
+ * @brief Pass an observation to the sink and count the result
+ *
+ * @param obs Observation to store
+ * @return short int 0 if it was stored, negative if not
+ */
+short int ObservationWriter::store(const Observation& obs) {
+    if (sink(obs) != 0) {
+        failed.fetch_add(1, memory_order_relaxed);
+        return -1;
+    }
+    written.fetch_add(1, memory_order_relaxed);
+    return 0;
+}
+
+/**
+ * @brief Loop of the writer thread
+ *
+ * Stores the observations of the ring in order and sleeps while it is
+ * empty. When the writer is stopped, the ring is drained before returning.
+ */
+void ObservationWriter::run() {
+    PackedObservation record;
+    Observation obs;
+    bool stopping;
+
+    obs.setStationId(station_id);
+
+    while (true) {
+        /* Read the flag before draining, so nothing published before stop() is left */
+        stopping = !running;
+        while (queue.pop(record)) {
+            record.unpack(obs);
+            if (store(obs) < 0)
+                lost = true;
+
+            /* Wake the acquisition thread if it waits for space or for the flush */
+            atomic_thread_fence(memory_order_seq_cst);
+            if (blocked.load(memory_order_relaxed)) {
+                lock_guard<mutex> guard(wake_lock);
+                space_cv.notify_one();
+            }
+        }
+        if (stopping)
+            break;
+
+        unique_lock<mutex> guard(wake_lock);
+        waiting = true;
+        atomic_thread_fence(memory_order_seq_cst);
+        wake_cv.wait_for(guard, OBSERVATION_WRITER_IDLE, [this]{ return !queue.empty() || !running; });
+        waiting = false;
+    }
+}
+
+/**
+ * @brief Get the number of observations waiting to be stored
+ *
+ * @return size_t Depth of the queue
+ */
+size_t ObservationWriter::getDepth() const {
+    return queue.size();
+}
+
+/**
+ * @brief Get the highest number of observations that have been waiting
+ *
+ * @return size_t High-water mark of the queue
+ */
+size_t ObservationWriter::getHighWater() const {
+    return queue.getHighWater();
+}
+
+/**
+ * @brief Get the number of observations dropped because the queue was full
+ *
+ * @return unsigned long Observations dropped
+ */
+unsigned long ObservationWriter::getDropped() const {
+    return queue.getDrops();
+}
+
+/**
+ * @brief Get the number of observations stored
+ *
+ * @return unsigned long Observations written
+ */
+unsigned long ObservationWriter::getWritten() const {
+    return written.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of observations the sink could not store
+ *
+ * @return unsigned long Observations failed
+ */
+unsigned long ObservationWriter::getFailed() const {
+    return failed.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Print the counters of the queue of every writer
+ *
+ * @param out Stream where the counters are printed
+ */
+void ObservationWriter::dumpDiagnostics(std::ostream& out) {
+    lock_guard<mutex> guard(writers_lock);
+
+    for (ObservationWriter* writer : writers) {
+        out << "Observation queue of " << writer->station_id << ": "
+            << writer->getDepth() << " waiting (high-water " << writer->getHighWater()
+            << " of " << OBSERVATION_QUEUE_SIZE << "), "
+            << writer->getWritten() << " written, "
+            << writer->getDropped() << " dropped, "
+            << writer->getFailed() << " failed" << endl;
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file ObservationWriter.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief ObservationWriter Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The ObservationWriter object stores the observations of a station from its
+ * own thread, so a slow DB does not delay the next acquisition.
+ */
+
+#ifndef OBSERVATIONWRITER_H
+#define OBSERVATIONWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "Observation.h"
+#include "PackedObservation.h"
+#include "SpscRing.h"
+
+/// Number of observations waiting to be stored, for each station.
+const size_t OBSERVATION_QUEUE_SIZE = 256;
+
+/// Function that stores an Observation, returning 0 if it was stored.
+typedef std::function<int(const Observation& obs)> ObservationSink;
+
+/**
+ * @brief ObservationWriter Class
+ *
+ * The acquisition thread of a station publishes each observation into a
+ * lock-free SpscRing of PackedObservation records, and the thread of the
+ * writer unpacks them and passes them to the sink (write_into_DB() for the
+ * stations), in order. The writer thread sleeps while the ring is empty.
+ * While the writer thread is not running (the offline sources, which are
+ * not paced by a station), publish() passes the observation to the sink
+ * itself.
+ *
+ * When the ring is full the observation is dropped, unless the writer waits
+ * for space (setWaitForSpace(), while the station history is recovered),
+ * and when the sink fails the observation is lost; in both cases the next
+ * publish() returns an error, so the worker recovers the station history
+ * from the last stored observation, after flush(). The depth of the queue,
+ * its high-water mark and the observations written, dropped and failed are
+ * printed by dumpDiagnostics(), for every writer running.
+ */
+class ObservationWriter
+{
+    /* ObservationWriter attributes */
+    protected:
+        /// Identifier of the station of the observations.
+        std::string station_id;
+        /// Function that stores each observation.
+        ObservationSink sink;
+        /// Observations waiting to be stored.
+        SpscRing<PackedObservation, OBSERVATION_QUEUE_SIZE> queue;
+        /// Thread storing the observations.
+        std::thread writer_thread;
+        /// The writer thread has to keep running.
+        std::atomic<bool> running;
+        /// The writer thread is waiting for observations.
+        std::atomic<bool> waiting;
+        /// The acquisition thread is waiting for the writer thread.
+        std::atomic<bool> blocked;
+        /// Protects the sleep of both threads.
+        std::mutex wake_lock;
+        /// Notified when an observation is published or the writer stops.
+        std::condition_variable wake_cv;
+        /// Notified when an observation is taken from the ring.
+        std::condition_variable space_cv;
+        /// publish() waits for space in the ring instead of dropping.
+        bool wait_for_space;
+        /// Observations queued or stored, written by the acquisition thread.
+        unsigned long published;
+        /// Set when an observation was dropped or could not be stored.
+        std::atomic<bool> lost;
+        /// Observations stored.
+        std::atomic<unsigned long> written;
+        /// Observations the sink could not store.
+        std::atomic<unsigned long> failed;
+
+        void run();
+        short int store(const Observation& obs);
+        void waitForWriter(std::function<bool()> done);
+
+    /* ObservationWriter public methods */
+    public:
+        ObservationWriter(const std::string& newStationId, ObservationSink newSink);
+        ~ObservationWriter();
+
+        ObservationWriter(const ObservationWriter&) = delete;
+        ObservationWriter& operator=(const ObservationWriter&) = delete;
+
+        void start();
+        void stop();
+
+        short int publish(const Observation& obs);
+        void setWaitForSpace(bool newWaitForSpace);
+        void flush();
+
+        size_t getDepth() const;
+        size_t getHighWater() const;
+        unsigned long getDropped() const;
+        unsigned long getWritten() const;
+        unsigned long getFailed() const;
+
+        static void dumpDiagnostics(std::ostream& out);
+};
+
+#endif
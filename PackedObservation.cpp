@@ -0,0 +1,196 @@
+/**
+ * @file PackedObservation.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief PackedObservation Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Compact record of an Observation, to keep long histories in memory. The
+ * values are stored in the fixed-point units of the station, so the
+ * Observations decoded from a frame are packed and unpacked without loss.
+ */
+
+#include "PackedObservation.h"
+
+#include <cmath>
+
+#include "frame_layout.h"
+
+using namespace std;
+
+static_assert(sizeof(PackedObservation) == 40, "PackedObservation is not packed");
+static_assert(FIELD_WIND_DIR == FIELD_WIND_SPEED + 1 && FIELD_UV == FIELD_WIND_DIR + 1 && FIELD_RAIN == FIELD_UV + 1,
+              "The statuses of PackedObservation do not match the DecodedFields");
+
+/// Statuses of the values up to the wind speed, kept as they are.
+const uint64_t PACKED_STATUS_LOW = ((uint64_t)1 << (FIELD_WIND_DIR * FIELD_STATUS_BITS)) - 1;
+
+/**
+ * @brief Round a value to an integer in a range
+ *
+ * @param value Value to round
+ * @param low Lowest integer allowed
+ * @param high Highest integer allowed
+ * @return long Closest integer in the range
+ */
+static inline long round_to_range(double value, long low, long high)
+{
+    if (!(value > low))
+        return low;
+    if (value > high)
+        return high;
+    return lround(value);
+}
+
+/**
+ * @brief Value of a number of tenths, calculated as the decoder does
+ *
+ * The decoder adds the tenths and units byte (divided by 10) to the tens,
+ * so the value is rebuilt from those two parts to get the same float.
+ *
+ * @param tenths Number of tenths
+ * @return double Value
+ */
+static inline double tenths_value(long tenths)
+{
+    return ((tenths % 100) / 10.0) + ((tenths / 100) * 10.0);
+}
+
+/**
+ * @brief Pack a temperature in 0.05 ºC
+ *
+ * @param value Temperature in ºC
+ * @return int16_t Temperature in 0.05 ºC
+ */
+static inline int16_t pack_temperature(float value)
+{
+    if (value == 0 && signbit(value))
+        return PACKED_NEGATIVE_ZERO;
+    return round_to_range(value * 20.0, PACKED_NEGATIVE_ZERO + 1, INT16_MAX);
+}
+
+/**
+ * @brief Unpack a temperature in 0.05 ºC
+ *
+ * @param code Temperature in 0.05 ºC
+ * @return float Temperature in ºC
+ */
+static inline float unpack_temperature(int16_t code)
+{
+    long halves = code < 0 ? -code : code;
+    float value;
+
+    if (code == PACKED_NEGATIVE_ZERO)
+        return -0.0f;
+
+    value = tenths_value(halves / 2);
+    if (halves % 2 == 1)
+        value += 0.05;
+    if (code < 0)
+        value *= -1;
+    return value;
+}
+
+/**
+ * @brief Pack a wind speed in 0.1 mph
+ *
+ * @param value Wind speed in kmh
+ * @return uint16_t Wind speed in 0.1 mph
+ */
+static inline uint16_t pack_wind(float value)
+{
+    return round_to_range(value / 3.6 * 2.23694 * 10, 0, (1 << PACKED_WIND_BITS) - 1);
+}
+
+/**
+ * @brief Unpack a wind speed in 0.1 mph
+ *
+ * The speeds over 100 mph have the 100 as a flag in the frame, which is
+ * also added apart.
+ *
+ * @param code Wind speed in 0.1 mph
+ * @return float Wind speed in kmh
+ */
+static inline float unpack_wind(uint16_t code)
+{
+    int offset = code >= 1000 ? 100 : 0;
+    float value = (tenths_value(code - offset * 10) + offset) / 2.23694;
+
+    return value * 3.6;
+}
+
+/**
+ * @brief Pack an Observation
+ *
+ * @param obs Observation to pack
+ */
+void PackedObservation::pack(const Observation& obs)
+{
+    uint64_t field_status = obs.getFieldStatus();
+
+    timestamp = obs.getTimestamp();
+    status = (field_status & PACKED_STATUS_LOW) |
+             ((uint64_t)get_field_status(field_status, FIELD_UV) << (FIELD_WIND_DIR * FIELD_STATUS_BITS));
+
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        temperature[i] = pack_temperature(obs.getTemperature(i));
+        humidity[i] = round_to_range(obs.getHumidity(i), 0, UINT8_MAX);
+    }
+
+    wind_chill = pack_temperature(obs.getWindChill());
+
+    pressure = round_to_range(obs.getPressure() * 16.0, 0, UINT16_MAX);
+    wind_gust = pack_wind(obs.getWindGust());
+    wind_speed = pack_wind(obs.getWindSpeed());
+    wind_dir = lround(obs.getWindDir() / 22.5) & 0x0F;
+    uv_index = round_to_range(obs.getUVIndex() * 10.0, 0, ((uint64_t)1 << (64 - PACKED_STATUS_BITS)) - 1);
+    rainfall = round_to_range(obs.getRainfall() / TE923Layout::RAIN_MM_PER_TIP, 0, UINT16_MAX);
+}
+
+/**
+ * @brief Unpack into an Observation
+ *
+ * The dew point and the RealFeel© are calculated again from the values, and
+ * the station identifier of the Observation is kept.
+ *
+ * @param obs Observation to fill
+ */
+void PackedObservation::unpack(Observation& obs) const
+{
+    uint64_t field_status = status & PACKED_STATUS_LOW;
+    uint32_t valid_fields = 0;
+
+    /* The direction follows the wind sensor, and the rain is always available */
+    field_status |= (uint64_t)wind_dir_status(get_field_status(field_status, FIELD_WIND_GUST),
+                                              get_field_status(field_status, FIELD_WIND_SPEED))
+                    << (FIELD_WIND_DIR * FIELD_STATUS_BITS);
+    field_status |= (uint64_t)get_field_status(status, FIELD_WIND_DIR) << (FIELD_UV * FIELD_STATUS_BITS);
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (get_field_status(field_status, field) == STATUS_OK)
+            valid_fields |= 1 << field;
+    }
+
+    obs.setTimestamp(timestamp);
+    obs.setValidFields(valid_fields);
+    obs.setFieldStatus(field_status);
+
+    for (int i = 0; i < OBSERVATION_CHANNELS; i++) {
+        obs.setTemperature(unpack_temperature(temperature[i]), i);
+        obs.setHumidity(humidity[i], i);
+    }
+
+    obs.setWindChill(unpack_temperature(wind_chill));
+    obs.setPressure(pressure * 0.0625);
+    obs.setWindGust(unpack_wind(wind_gust));
+    obs.setWindSpeed(unpack_wind(wind_speed));
+    obs.setWindDir((wind_dir & 0x0F) * 22.5);
+    obs.setUVIndex(tenths_value(uv_index));
+    obs.setRainfall(rainfall * TE923Layout::RAIN_MM_PER_TIP);
+
+    obs.setDewPoint(0.0);
+    obs.setRealFeel(0.0);
+    obs.calculateDewPoint();
+    obs.calculateRealFeel(lround(obs.getUVIndex()));
+}
@@ -0,0 +1,77 @@
+/**
+ * @file PackedObservation.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief PackedObservation Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Compact record of an Observation, to keep long histories in memory. The
+ * values are stored in the fixed-point units of the station, so the
+ * Observations decoded from a frame are packed and unpacked without loss.
+ */
+
+#ifndef PACKEDOBSERVATION_H
+#define PACKEDOBSERVATION_H
+
+#include <cstdint>
+
+#include "data_decoder.h"
+#include "Observation.h"
+
+/// Bits of PackedObservation::status: the status of every value up to the
+/// wind speed, then the one of the UV index.
+const int PACKED_STATUS_BITS = (FIELD_WIND_SPEED + 2) * FIELD_STATUS_BITS;
+/// Bits of the wind gust and the wind speed of a PackedObservation.
+const int PACKED_WIND_BITS = 14;
+/// Code of a temperature of -0.0 ºC in a PackedObservation.
+const int16_t PACKED_NEGATIVE_ZERO = INT16_MIN;
+
+/**
+ * @brief PackedObservation Class
+ *
+ * Record of 40 bytes with the values of an Observation in the units of the
+ * station: temperatures in 0.05 ºC, pressure in 1/16 mb, wind in 0.1 mph,
+ * UV index in 0.1, rain in tips of the bucket and the wind direction as one
+ * of its 16 points.
+ *
+ * The status mask of the frame is kept, so a value lost with its sensor is
+ * still told apart from one out of range. The statuses of the wind
+ * direction and the rain are not stored, they are rebuilt from the ones of
+ * the gust and the speed as decode_frame() does (the rain is always
+ * available), and the valid flags are the values with STATUS_OK.
+ *
+ * The values of the frames decoded by data_decoder are restored exactly.
+ * The dew point and the RealFeel© are calculated again when unpacking, and
+ * the station identifier is not kept (the histories are per station).
+ */
+struct PackedObservation {
+    /// FieldStatus of the values, except the wind direction and the rain.
+    uint64_t status : PACKED_STATUS_BITS;
+    /// UV index in 0.1.
+    uint64_t uv_index : 64 - PACKED_STATUS_BITS;
+    /// Timestamp of when the observation is made.
+    uint32_t timestamp;
+    /// Wind gust in 0.1 mph.
+    uint32_t wind_gust : PACKED_WIND_BITS;
+    /// Wind speed in 0.1 mph.
+    uint32_t wind_speed : PACKED_WIND_BITS;
+    /// Wind direction (steps of 22.5º).
+    uint32_t wind_dir : 32 - 2 * PACKED_WIND_BITS;
+    /// Temperatures of the channels, in 0.05 ºC (PACKED_NEGATIVE_ZERO for -0.0).
+    int16_t temperature[OBSERVATION_CHANNELS];
+    /// Wind chill in 0.05 ºC (PACKED_NEGATIVE_ZERO for -0.0).
+    int16_t wind_chill;
+    /// Pressure in 1/16 mb.
+    uint16_t pressure;
+    /// Accumulated rain, in tips of the bucket.
+    uint16_t rainfall;
+    /// Humidity of the channels, in %.
+    uint8_t humidity[OBSERVATION_CHANNELS];
+
+    void pack(const Observation& obs);
+    void unpack(Observation& obs) const;
+};
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file ReplayFrameSource.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief ReplayFrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The ReplayFrameSource object provides the frames stored in a capture file,
+ * as fast as possible or keeping their original spacing.
+ */
+
+#include "ReplayFrameSource.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Construct a new ReplayFrameSource object
+ *
+ * @param newSpeed 0 to replay as fast as possible, or the factor dividing the
+ * original spacing of the frames
+ */
+ReplayFrameSource::ReplayFrameSource(double newSpeed) {
+    speed = newSpeed;
+    first_us = -1;
+    skipped = 0;
+}
+
+/**
+ * @brief Open the capture file to replay
+ *
+ * @param path Path of the capture file
+ * @return short int Result of the execution of the function.
+ */
+short int ReplayFrameSource::open(const std::string& path) {
+    first_us = -1;
+    skipped = 0;
+    return frame_log.openRead(path);
+}
+
+/**
+ * @brief Read the next valid frame of the capture file
+ *
+ * With a speed factor, it waits until the frame is due, counting from the
+ * first frame replayed.
+ *
+ * @param receive_buffer Buffer where the frame is stored.
+ * @param timestamp Time when the frame was captured.
+ * @return short int 0 if a frame was read, 1 at the end of the file,
+ * negative if the file is not opened.
+ */
+short int ReplayFrameSource::readFrame(unsigned char* receive_buffer, unsigned int &timestamp) {
+    FrameLogRecord record;
+    short int retValue;
+
+    do {
+        retValue = frame_log.next(record);
+        if (retValue != 0)
+            return retValue;
+        if (!record.crc_ok)
+            skipped++;
+    } while (!record.crc_ok);
+
+    if (speed > 0) {
+        if (first_us < 0) {
+            first_us = record.timestamp_us;
+            replay_start = chrono::steady_clock::now();
+        } else if (record.timestamp_us > first_us) {
+            this_thread::sleep_until(replay_start +
+                chrono::microseconds((int64_t)((record.timestamp_us - first_us) / speed)));
+        }
+    }
+
+    memcpy(receive_buffer, record.frame, BUFLEN);
+    timestamp = record.timestamp_us / 1000000;
+
+    return 0;
+}
+
+/**
+ * @brief Get the number of frames skipped because of their CRC
+ *
+ * @return int Number of frames skipped
+ */
+int ReplayFrameSource::getSkipped() {
+    return skipped;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file ReplayFrameSource.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief ReplayFrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The ReplayFrameSource object provides the frames stored in a capture file,
+ * as fast as possible or keeping their original spacing.
+ */
+
+#ifndef REPLAYFRAMESOURCE_H
+#define REPLAYFRAMESOURCE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "FrameLog.h"
+#include "FrameSource.h"
+
+/**
+ * @brief ReplayFrameSource Class
+ *
+ * Frame source reading a capture file written by FrameLog. The frames with an
+ * invalid CRC are skipped (and counted), as they would never leave the USB
+ * layer.
+ */
+class ReplayFrameSource : public FrameSource
+{
+    /* ReplayFrameSource attributes */
+    protected:
+        /// Capture file being replayed.
+        FrameLog frame_log;
+        /// 0 to replay as fast as possible, or the factor dividing the
+        /// original spacing of the frames.
+        double speed;
+        /// Capture time of the first frame replayed (-1 before it).
+        int64_t first_us;
+        /// Moment the first frame was replayed.
+        std::chrono::steady_clock::time_point replay_start;
+        /// Number of frames skipped because of their CRC.
+        int skipped;
+
+    /* ReplayFrameSource public methods */
+    public:
+        ReplayFrameSource(double newSpeed);
+
+        short int open(const std::string& path);
+        short int readFrame(unsigned char* receive_buffer, unsigned int &timestamp);
+
+        int getSkipped();
+};
+
+#endif
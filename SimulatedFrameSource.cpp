@@ -0,0 +1,226 @@
+/**
+ * @file SimulatedFrameSource.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief SimulatedFrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The SimulatedFrameSource object generates synthetic TE923 frames, so the
+ * decoding and the sinks can be exercised (and loaded) without a station.
+ */
+
+#include "SimulatedFrameSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#include "data_decoder.h"
+
+using namespace std;
+
+/**
+ * @brief Encode a value from 0 to 99 as BCD
+ *
+ * @param value Value to encode
+ * @return unsigned char BCD representation of the value
+ */
+static unsigned char int2bcd(int value) {
+    return (unsigned char)(((value / 10) % 10) << 4 | (value % 10));
+}
+
+/**
+ * @brief Encode a temperature in its two bytes
+ *
+ * The first byte has the tenths and units, and the second one the tens, the
+ * 0.05 flag, the link flag and the sign flag.
+ *
+ * @param raw_data Frame to fill
+ * @param offset Position of the first byte
+ * @param value Temperature to encode (ºC)
+ */
+static void encode_temperature(unsigned char* raw_data, int offset, float value) {
+    int halves = min((int)lround(fabs(value) * 20), 1999);
+    int tenths = halves / 2;
+
+    raw_data[offset] = int2bcd(tenths % 100);
+    raw_data[offset + 1] = ((tenths / 100) & 0x0F) | 0x40;
+    if (halves % 2)
+        raw_data[offset + 1] |= 0x20;
+    if (value >= 0)
+        raw_data[offset + 1] |= 0x80;
+}
+
+/**
+ * @brief Encode a wind speed in its two bytes
+ *
+ * @param raw_data Frame to fill
+ * @param offset Position of the first byte
+ * @param value Wind speed to encode (mph)
+ */
+static void encode_wind(unsigned char* raw_data, int offset, float value) {
+    int tenths = min((int)lround(value * 10), 1999);
+
+    raw_data[offset] = int2bcd(tenths % 100);
+    raw_data[offset + 1] = (tenths / 100) % 10;
+    if (tenths >= 1000)
+        raw_data[offset + 1] |= 0x10;
+}
+
+/**
+ * @brief Construct a new SimulatedFrameSource object
+ *
+ * @param newRate Frames per second, 0 to generate them as fast as possible
+ * @param newMaxFrames Number of frames to generate, 0 for no limit
+ * @param seed Seed of the random generator
+ */
+SimulatedFrameSource::SimulatedFrameSource(double newRate, long newMaxFrames, unsigned int seed) {
+    rate = newRate;
+    max_frames = newMaxFrames;
+    generated = 0;
+    errors.crc_rate = 0;
+    errors.sensor_lost_rate = 0;
+    errors.no_link_rate = 0;
+    errors.out_of_range_rate = 0;
+    generator.seed(seed);
+
+    for (int i = 0; i < TE923_CHANNELS; i++) {
+        temperature[i] = 20.0 + i;
+        humidity[i] = 50.0 + i;
+    }
+    pressure = 1013.0;
+    wind_speed = 5.0;
+    wind_dir = 0;
+    rain_count = 0;
+}
+
+/**
+ * @brief Set the error patterns to inject
+ *
+ * @param newErrors Probabilities of each error pattern
+ */
+void SimulatedFrameSource::setErrors(const SimulationErrors& newErrors) {
+    errors = newErrors;
+}
+
+/**
+ * @brief Advance the simulated values one step of their random walk
+ */
+void SimulatedFrameSource::stepValues() {
+    normal_distribution<float> step(0.0, 0.1);
+    uniform_int_distribution<int> dir_step(-1, 1);
+    uniform_int_distribution<int> rain(0, 99);
+
+    for (int i = 0; i < TE923_CHANNELS; i++) {
+        temperature[i] = max(-40.0f, min(60.0f, temperature[i] + step(generator)));
+        humidity[i] = max(1.0f, min(99.0f, humidity[i] + step(generator) * 5));
+    }
+    pressure = max(950.0f, min(1050.0f, pressure + step(generator)));
+    wind_speed = max(0.0f, min(150.0f, wind_speed + step(generator) * 5));
+    wind_dir = (wind_dir + dir_step(generator) + 16) % 16;
+    if (rain(generator) == 0)
+        rain_count = (rain_count + 1) & 0xFFFF;
+}
+
+/**
+ * @brief Encode the current values as a frame with a valid CRC
+ *
+ * @param receive_buffer Frame to fill
+ */
+void SimulatedFrameSource::encodeFrame(unsigned char* receive_buffer) {
+    int press = lround(pressure / 0.0625);
+    int uv = 35;
+    float gust = wind_speed * 1.3;
+    float chill = temperature[0] - wind_speed / 10;
+
+    memset(receive_buffer, 0, BUFLEN);
+
+    for (int i = 0; i < TE923_CHANNELS; i++) {
+        encode_temperature(receive_buffer, i * 3, temperature[i]);
+        receive_buffer[i * 3 + 2] = int2bcd(lround(humidity[i]));
+    }
+
+    receive_buffer[18] = int2bcd(uv % 100);
+    receive_buffer[19] = (uv / 100) % 10;
+    receive_buffer[20] = press & 0xFF;
+    receive_buffer[21] = (press >> 8) & 0xFF;
+    encode_temperature(receive_buffer, 23, chill);
+    encode_wind(receive_buffer, 25, gust);
+    encode_wind(receive_buffer, 27, wind_speed);
+    receive_buffer[29] = wind_dir & 0x0F;
+    receive_buffer[30] = rain_count & 0xFF;
+    receive_buffer[31] = (rain_count >> 8) & 0xFF;
+
+    for (int i = 0; i <= 32; i++)
+        receive_buffer[33] ^= receive_buffer[i];
+}
+
+/**
+ * @brief Inject the error patterns in a frame
+ *
+ * The sensor errors are injected before the CRC is fixed again, as the
+ * station would report them. The CRC error is injected afterwards.
+ *
+ * @param receive_buffer Frame to modify
+ */
+void SimulatedFrameSource::injectErrors(unsigned char* receive_buffer) {
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    uniform_int_distribution<int> channel(1, TE923_CHANNELS - 1);
+    int offset;
+
+    if (chance(generator) < errors.sensor_lost_rate) {
+        offset = channel(generator) * 3;
+        receive_buffer[offset] = 0xBB;
+        receive_buffer[offset + 1] = 0x0B;
+    }
+    if (chance(generator) < errors.no_link_rate) {
+        offset = channel(generator) * 3;
+        receive_buffer[offset] = 0xAA;
+        receive_buffer[offset + 1] = 0x0A;
+    }
+    if (chance(generator) < errors.out_of_range_rate) {
+        receive_buffer[27] = 0xEE;
+        receive_buffer[28] = 0x8E;
+    }
+
+    receive_buffer[33] = 0x00;
+    for (int i = 0; i <= 32; i++)
+        receive_buffer[33] ^= receive_buffer[i];
+
+    if (chance(generator) < errors.crc_rate)
+        receive_buffer[33] ^= 0x01;
+}
+
+/**
+ * @brief Generate the next frame
+ *
+ * With a rate, it waits until the frame is due, counting from the first
+ * frame generated, so the rate is kept even if some frames take longer.
+ *
+ * @param receive_buffer Buffer where the frame is stored.
+ * @param timestamp Time when the frame was generated.
+ * @return short int 0 if a frame was generated, 1 when the limit of frames
+ * is reached.
+ */
+short int SimulatedFrameSource::readFrame(unsigned char* receive_buffer, unsigned int &timestamp) {
+    if (max_frames > 0 && generated >= max_frames)
+        return 1;
+
+    if (generated == 0) {
+        start = chrono::steady_clock::now();
+    } else if (rate > 0) {
+        this_thread::sleep_until(start + chrono::nanoseconds((int64_t)(generated * 1e9 / rate)));
+    }
+
+    stepValues();
+    encodeFrame(receive_buffer);
+    injectErrors(receive_buffer);
+    timestamp = time(nullptr);
+    generated++;
+
+    return 0;
+}
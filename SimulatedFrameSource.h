@@ -0,0 +1,92 @@
+/**
+ * @file SimulatedFrameSource.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief SimulatedFrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The SimulatedFrameSource object generates synthetic TE923 frames, so the
+ * decoding and the sinks can be exercised (and loaded) without a station.
+ */
+
+#ifndef SIMULATEDFRAMESOURCE_H
+#define SIMULATEDFRAMESOURCE_H
+
+#include <chrono>
+#include <random>
+
+#include "FrameSource.h"
+
+/// Number of temperature/humidity channels of a TE923 frame.
+const int TE923_CHANNELS = 6;
+
+/**
+ * @brief Error patterns injected by the simulated station
+ *
+ * Each value is the probability (0 to 1) of the error in a frame.
+ */
+struct SimulationErrors {
+    /// The CRC byte of the frame is corrupted.
+    double crc_rate;
+    /// A remote temperature/humidity sensor is reported as lost.
+    double sensor_lost_rate;
+    /// A remote temperature/humidity sensor has no link.
+    double no_link_rate;
+    /// The wind speed is reported as out of range.
+    double out_of_range_rate;
+};
+
+/**
+ * @brief SimulatedFrameSource Class
+ *
+ * Frame source generating valid BCD encoded frames with a correct XOR CRC.
+ * The values follow a random walk around typical conditions, and the error
+ * patterns are injected with the configured probabilities. The frames are
+ * generated at a fixed rate (or as fast as possible), with a deterministic
+ * sequence for a given seed.
+ */
+class SimulatedFrameSource : public FrameSource
+{
+    /* SimulatedFrameSource attributes */
+    protected:
+        /// Frames per second, 0 to generate them as fast as possible.
+        double rate;
+        /// Number of frames to generate, 0 for no limit.
+        long max_frames;
+        /// Number of frames generated.
+        long generated;
+        /// Error patterns injected.
+        SimulationErrors errors;
+        /// Random generator of the values and the errors.
+        std::mt19937 generator;
+        /// Moment the first frame was generated.
+        std::chrono::steady_clock::time_point start;
+
+        /// Current temperatures of the channels (ºC).
+        float temperature[TE923_CHANNELS];
+        /// Current humidities of the channels (%).
+        float humidity[TE923_CHANNELS];
+        /// Current pressure (mb).
+        float pressure;
+        /// Current wind speed (mph).
+        float wind_speed;
+        /// Current wind direction (0 to 15).
+        int wind_dir;
+        /// Current rain counter.
+        int rain_count;
+
+        void stepValues();
+        void encodeFrame(unsigned char* receive_buffer);
+        void injectErrors(unsigned char* receive_buffer);
+
+    /* SimulatedFrameSource public methods */
+    public:
+        SimulatedFrameSource(double newRate, long newMaxFrames, unsigned int seed);
+
+        void setErrors(const SimulationErrors& newErrors);
+        short int readFrame(unsigned char* receive_buffer, unsigned int &timestamp);
+};
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file SpscRing.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief SpscRing Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Bounded lock-free queue between one producer thread and one consumer
+ * thread, used to pass the observations from the acquisition of a station
+ * to the thread that stores them.
+ */
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+
+/// Size of a cache line, the indexes of the producer and the consumer are kept apart.
+const size_t SPSC_CACHE_LINE = 64;
+
+/**
+ * @brief SpscRing Class
+ *
+ * Ring of Size items (a power of 2) with a single producer, which calls
+ * push(), and a single consumer, which calls pop(). Neither of them locks or
+ * waits: push() fails when the ring is full and pop() when it is empty. The
+ * items are copied in and out, so T should be a small plain record.
+ *
+ * The producer and the consumer indexes are in different cache lines. The
+ * consumer keeps a copy of the producer index and only reads the shared one
+ * when its copy says the ring is empty. The producer reads the consumer
+ * index on every push, because it also counts the highest depth reached
+ * (and the items dropped because the ring was full).
+ */
+template<typename T, size_t Size>
+class SpscRing
+{
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "The size of an SpscRing has to be a power of 2");
+
+    /* SpscRing attributes */
+    protected:
+        /// Items pushed, written by the producer.
+        std::atomic<size_t> tail;
+        /// Items dropped because the ring was full, written by the producer.
+        std::atomic<unsigned long> drops;
+        /// Highest number of items in the ring, written by the producer.
+        std::atomic<size_t> high_water;
+        char producer_padding[SPSC_CACHE_LINE];
+
+        /// Items popped, written by the consumer.
+        std::atomic<size_t> head;
+        /// Copy of tail seen by the consumer.
+        size_t cached_tail;
+        char consumer_padding[SPSC_CACHE_LINE];
+
+        /// Items of the ring.
+        T items[Size];
+
+    /* SpscRing public methods */
+    public:
+        SpscRing();
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        bool push(const T& item);
+        bool pop(T& item);
+
+        size_t size() const;
+        bool empty() const;
+        static constexpr size_t capacity() { return Size; }
+        unsigned long getDrops() const;
+        size_t getHighWater() const;
+};
+
+/**
+ * @brief Construct a new, empty SpscRing object
+ */
+template<typename T, size_t Size>
+SpscRing<T, Size>::SpscRing() : tail(0), drops(0), high_water(0), head(0), cached_tail(0)
+{
+}
+
+/**
+ * @brief Add an item at the end of the ring (producer only)
+ *
+ * @param item Item to add
+ * @return true The item was added
+ * @return false The ring is full, the item was dropped
+ */
+template<typename T, size_t Size>
+bool SpscRing<T, Size>::push(const T& item)
+{
+    size_t current = tail.load(std::memory_order_relaxed);
+    size_t depth = current + 1 - head.load(std::memory_order_acquire);
+
+    if (depth > Size) {
+        drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    items[current & (Size - 1)] = item;
+    tail.store(current + 1, std::memory_order_release);
+
+    if (depth > high_water.load(std::memory_order_relaxed))
+        high_water.store(depth, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Take the item at the beginning of the ring (consumer only)
+ *
+ * @param item Where the item is copied
+ * @return true An item was taken
+ * @return false The ring is empty
+ */
+template<typename T, size_t Size>
+bool SpscRing<T, Size>::pop(T& item)
+{
+    size_t current = head.load(std::memory_order_relaxed);
+
+    if (current == cached_tail) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (current == cached_tail)
+            return false;
+    }
+
+    item = items[current & (Size - 1)];
+    head.store(current + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Get the number of items in the ring
+ *
+ * From any thread, it is only a snapshot.
+ *
+ * @return size_t Number of items
+ */
+template<typename T, size_t Size>
+size_t SpscRing<T, Size>::size() const
+{
+    size_t current_head = head.load(std::memory_order_acquire);
+
+    return tail.load(std::memory_order_acquire) - current_head;
+}
+
+/**
+ * @brief Check if the ring has no items
+ *
+ * @return true The ring is empty
+ * @return false There are items to pop
+ */
+template<typename T, size_t Size>
+bool SpscRing<T, Size>::empty() const
+{
+    return size() == 0;
+}
+
+/**
+ * @brief Get the number of items dropped because the ring was full
+ *
+ * @return unsigned long Items dropped
+ */
+template<typename T, size_t Size>
+unsigned long SpscRing<T, Size>::getDrops() const
+{
+    return drops.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the highest number of items the ring has had
+ *
+ * @return size_t High-water mark of the depth
+ */
+template<typename T, size_t Size>
+size_t SpscRing<T, Size>::getHighWater() const
+{
+    return high_water.load(std::memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,359 @@
+/**
+ * @file StationWorker.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief StationWorker Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The StationWorker object runs the acquisition loop of a single TE923
+ * station in its own thread, so several stations attached to the same host
+ * are sampled independently.
+ */
+
+#include "StationWorker.h"
+
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "HistoryReader.h"
+#include "main.h"
+#include "network_utils.hpp"
+
+using namespace std;
+
+/// Seconds between two acquisitions of the same station.
+const int ACQUISITION_PERIOD = 30;
+
+/**
+ * @brief Construct a new StationWorker object
+ *
+ * The acquisition loop is not started until start() is called.
+ *
+ * @param sharedCtx libusb context where the devices are found
+ * @param newStationId Identifier of the station (bus-port path)
+ * @param newHandler Function called with each frame read
+ * @param newAsyncMode True to use the event-driven transfers
+ * @param newHistoryRecords Number of records of the station history ring
+ */
+StationWorker::StationWorker(libusb_context *sharedCtx, const std::string& newStationId, FrameHandler newHandler, bool newAsyncMode, int newHistoryRecords)
+    : observation_writer(newStationId, write_into_DB) {
+    ctx = sharedCtx;
+    station_id = newStationId;
+    handler = newHandler;
+    async_mode = newAsyncMode;
+    period = chrono::seconds(ACQUISITION_PERIOD);
+    running = false;
+    device = NULL;
+    device_generation = 0;
+    session = NULL;
+    source = NULL;
+    session_generation = 0;
+    history_records = newHistoryRecords;
+    backfill_pending = true;
+}
+
+/**
+ * @brief Destroy the StationWorker object
+ */
+StationWorker::~StationWorker() {
+    stop();
+    if (device != NULL) {
+        libusb_unref_device(device);
+        device = NULL;
+    }
+}
+
+/**
+ * @brief Select the directory where the frames are captured
+ *
+ * Every frame received from the station is appended to the file
+ * "<station_id>.frames" of the directory. It has to be called before start().
+ *
+ * @param newCaptureDir Directory of the capture, empty to not capture
+ */
+void StationWorker::setCaptureDir(const std::string& newCaptureDir) {
+    capture_dir = newCaptureDir;
+}
+
+/**
+ * @brief Start the acquisition thread and the writer of the observations
+ */
+void StationWorker::start() {
+    if (running)
+        return;
+    if (!capture_dir.empty())
+        capture_log.openWrite(capture_dir + "/" + station_id + ".frames");
+    observation_writer.start();
+    running = true;
+    worker_thread = thread(&StationWorker::run, this);
+}
+
+/**
+ * @brief Stop the acquisition thread and close the session
+ *
+ * The observations already published are stored before returning.
+ */
+void StationWorker::stop() {
+    {
+        lock_guard<mutex> guard(device_lock);
+        running = false;
+        device_cv.notify_all();
+    }
+    if (worker_thread.joinable())
+        worker_thread.join();
+    observation_writer.stop();
+
+    delete source;
+    source = NULL;
+    delete session;
+    session = NULL;
+}
+
+/**
+ * @brief Record the arrival of the device of the station
+ *
+ * @param newDevice Device that arrived
+ */
+void StationWorker::deviceArrived(libusb_device *newDevice) {
+    lock_guard<mutex> guard(device_lock);
+
+    if (device == newDevice)
+        return;
+    if (device != NULL)
+        libusb_unref_device(device);
+    device = libusb_ref_device(newDevice);
+    device_generation++;
+    cerr << "TE923 device connected at " << station_id << endl;
+    device_cv.notify_all();
+}
+
+/**
+ * @brief Record the removal of the device of the station
+ *
+ * Devices of other stations are ignored.
+ *
+ * @param oldDevice Device that left (NULL for the current one, whatever it is)
+ */
+void StationWorker::deviceLeft(libusb_device *oldDevice) {
+    lock_guard<mutex> guard(device_lock);
+
+    if (device == NULL || (oldDevice != NULL && device != oldDevice))
+        return;
+    libusb_unref_device(device);
+    device = NULL;
+    cerr << "TE923 device disconnected from " << station_id << endl;
+    device_cv.notify_all();
+}
+
+/**
+ * @brief Get the identifier of the station
+ *
+ * @return std::string Identifier of the station (bus-port path)
+ */
+std::string StationWorker::getStationId() {
+    return station_id;
+}
+
+/**
+ * @brief Obtain the identifier of the station attached as a device
+ *
+ * The identifier is the bus number and the port path, like "1-1.4", which is
+ * stable while the station is kept in the same port of the hub.
+ *
+ * @param dev Device of the station
+ * @return std::string Identifier of the station
+ */
+std::string StationWorker::stationIdOf(libusb_device *dev) {
+    uint8_t ports[8];
+    int num_ports;
+    stringstream ssId;
+
+    ssId << (int)libusb_get_bus_number(dev);
+    num_ports = libusb_get_port_numbers(dev, ports, sizeof(ports));
+    for (int i = 0; i < num_ports; i++) {
+        ssId << (i == 0 ? "-" : ".") << (int)ports[i];
+    }
+    if (num_ports <= 0)
+        ssId << "-" << (int)libusb_get_device_address(dev);
+
+    return ssId.str();
+}
+
+/**
+ * @brief Acquisition loop of the station
+ *
+ * Pauses while the device is missing, reads a frame each period and passes
+ * it to the handler. After a failed read, it retries as soon as the device
+ * is enumerated again. Before passing a live frame, the pending history is
+ * recovered. Each frame is read in place into a slot of the frame pool of the
+ * worker, which is shared with the handler.
+ */
+void StationWorker::run() {
+    FrameHandle slot;
+
+    while (running) {
+        /* Wait (paused) until the USB device is attached */
+        if (!waitForDevice(period))
+            continue;
+
+        slot = frame_pool.acquire();
+        if (slot.empty()) {
+            cerr << "No free frame slots for " << station_id << endl;
+            waitForNextCycle();
+            continue;
+        }
+
+        /* Obtain the data from the USB device */
+        if (readFrame(slot.frame(), slot.timestamp()) < 0) {
+            /* Retry as soon as the device reappears, or in the next cycle */
+            waitForReconnection(period);
+            backfill_pending = true;
+            continue;
+        }
+
+        /* Recover the records missed while not running, oldest first */
+        if (backfill_pending)
+            backfill();
+
+        if (handler(station_id, slot, observation_writer) < 0)
+            backfill_pending = true;
+        slot.reset();
+
+        waitForNextCycle();
+    }
+}
+
+/**
+ * @brief Read the current values frame from the device of the station
+ *
+ * If the device changed since the last read, the session is recreated for
+ * the new one.
+ *
+ * @param receive_buffer Buffer where the retreived information is stored.
+ * @param timestamp Time when the frame was read.
+ * @return short int Result of the execution of the function.
+ */
+short int StationWorker::readFrame(unsigned char* receive_buffer, unsigned int &timestamp) {
+    {
+        lock_guard<mutex> guard(device_lock);
+
+        if (device == NULL) {
+            delete source;
+            source = NULL;
+            delete session;
+            session = NULL;
+            return -2;
+        }
+        if (session == NULL || session_generation != device_generation) {
+            delete source;
+            delete session;
+            session = new UsbSession(ctx, device);
+            source = new UsbFrameSource(session);
+            session->setAsyncMode(async_mode);
+            if (!capture_dir.empty())
+                session->setCaptureLog(&capture_log);
+            session_generation = device_generation;
+        }
+    }
+
+    return source->readFrame(receive_buffer, timestamp);
+}
+
+/**
+ * @brief Wait until the device is attached
+ *
+ * @param timeout Maximum time to wait
+ * @return true The device is attached and the worker is running
+ * @return false The timeout expired, or the worker was stopped
+ */
+bool StationWorker::waitForDevice(chrono::milliseconds timeout) {
+    unique_lock<mutex> guard(device_lock);
+    device_cv.wait_for(guard, timeout, [this]{ return device != NULL || !running; });
+    return device != NULL && running;
+}
+
+/**
+ * @brief Wait until the device is attached again
+ *
+ * Used after a failed read: it returns as soon as the device is reported as
+ * arrived (again), so a reset of the device only costs the time it takes to
+ * enumerate it.
+ *
+ * @param timeout Maximum time to wait
+ * @return true A new arrival of the device was reported
+ * @return false The timeout expired without a new arrival
+ */
+bool StationWorker::waitForReconnection(chrono::milliseconds timeout) {
+    unique_lock<mutex> guard(device_lock);
+    unsigned int last_generation = session_generation;
+    return device_cv.wait_for(guard, timeout, [this, last_generation]{
+        return (device != NULL && device_generation != last_generation) || !running;
+    });
+}
+
+/**
+ * @brief Wait for the next acquisition, or until the worker is stopped
+ */
+void StationWorker::waitForNextCycle() {
+    unique_lock<mutex> guard(device_lock);
+    device_cv.wait_for(guard, period, [this]{ return !running; });
+}
+
+/**
+ * @brief Recover the history records not stored yet
+ *
+ * Asks the DB for the last observation stored for the station and dumps the
+ * newer records of the station history, passing them to the handler from the
+ * oldest to the newest. If the DB cannot be reached, or a record cannot be
+ * stored, the recovery is retried in the next cycle.
+ *
+ * The observations still queued are stored first, so the DB knows the last
+ * one, and the records wait for space in the queue of the writer instead of
+ * being dropped.
+ */
+void StationWorker::backfill() {
+    vector<HistoryRecord> records;
+    FrameHandle slot;
+    long last_timestamp;
+    int dumped;
+
+    observation_writer.flush();
+    last_timestamp = obtain_last_stored_timestamp(station_id);
+    if (last_timestamp < 0)
+        return;
+
+    backfill_pending = false;
+    if (last_timestamp == 0 || time(nullptr) - last_timestamp <= 2 * period.count())
+        return;
+
+    HistoryReader reader(session, history_records);
+    dumped = reader.dumpSince(last_timestamp, records);
+    if (dumped < 0) {
+        cerr << "Error reading the history of " << station_id << endl;
+        backfill_pending = true;
+        return;
+    }
+    cerr << "Recovering " << dumped << " history records of " << station_id << endl;
+
+    observation_writer.setWaitForSpace(true);
+    for (auto &record : records) {
+        slot = frame_pool.acquire();
+        if (slot.empty()) {
+            backfill_pending = true;
+            break;
+        }
+        memcpy(slot.frame(), record.frame, BUFLEN);
+        slot.timestamp() = record.timestamp;
+
+        if (handler(station_id, slot, observation_writer) < 0) {
+            backfill_pending = true;
+            break;
+        }
+    }
+    observation_writer.setWaitForSpace(false);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file StationWorker.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief StationWorker Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The StationWorker object runs the acquisition loop of a single TE923
+ * station in its own thread, so several stations attached to the same host
+ * are sampled independently.
+ */
+
+#ifndef STATIONWORKER_H
+#define STATIONWORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <libusb-1.0/libusb.h>
+
+#include "FrameLog.h"
+#include "FramePool.h"
+#include "ObservationWriter.h"
+#include "UsbFrameSource.h"
+#include "UsbSession.h"
+
+/// Function called with the slot of each valid frame read from a station,
+/// holding the time it was measured, and the writer where its observation
+/// is published. It returns a negative value if the frame was not stored.
+typedef std::function<short int(const std::string& station_id, FrameHandle& frame, ObservationWriter& writer)> FrameHandler;
+
+/**
+ * @brief StationWorker Class
+ *
+ * Acquisition worker of a station, identified by the USB bus and port path
+ * where it is attached. The device itself can come and go (it is reported by
+ * the DeviceManager): the worker pauses while it is missing and recreates its
+ * UsbSession when it arrives again.
+ *
+ * The observations are stored by an ObservationWriter of the station, in its
+ * own thread. When the worker starts, when the device comes back and when a
+ * frame could not be stored, the records kept in the station history since
+ * the last stored observation are recovered before the next live frame.
+ */
+class StationWorker
+{
+    /* StationWorker attributes */
+    protected:
+        /// libusb context where the devices are found.
+        libusb_context *ctx;
+        /// Identifier of the station (bus-port path).
+        std::string station_id;
+        /// Function called with each frame read.
+        FrameHandler handler;
+        /// Acquisition mode of the sessions created.
+        bool async_mode;
+        /// Time between two acquisitions.
+        std::chrono::seconds period;
+        /// Thread running the acquisition loop.
+        std::thread worker_thread;
+        /// The acquisition loop has to keep running.
+        std::atomic<bool> running;
+        /// Protects the device attributes.
+        std::mutex device_lock;
+        /// Notified when the device arrives or leaves, or the worker stops.
+        std::condition_variable device_cv;
+        /// Device currently attached (NULL if none).
+        libusb_device *device;
+        /// Incremented each time the device arrives.
+        unsigned int device_generation;
+        /// Session with the attached device (only used by the worker thread).
+        UsbSession *session;
+        /// Frame source reading through the session.
+        UsbFrameSource *source;
+        /// Generation of the device the session was created for.
+        unsigned int session_generation;
+        /// Number of records of the history ring of the station model.
+        int history_records;
+        /// The history has to be recovered before the next live frame.
+        bool backfill_pending;
+        /// Directory where the frames are captured (empty if not capturing).
+        std::string capture_dir;
+        /// Log where the frames of the station are captured.
+        FrameLog capture_log;
+        /// Slots where the frames of the station are read and decoded.
+        FramePool frame_pool;
+        /// Writer storing the observations of the station.
+        ObservationWriter observation_writer;
+
+        void run();
+        short int readFrame(unsigned char* receive_buffer, unsigned int &timestamp);
+        bool waitForDevice(std::chrono::milliseconds timeout);
+        bool waitForReconnection(std::chrono::milliseconds timeout);
+        void waitForNextCycle();
+        void backfill();
+
+    /* StationWorker public methods */
+    public:
+        StationWorker(libusb_context *sharedCtx, const std::string& newStationId, FrameHandler newHandler, bool newAsyncMode, int newHistoryRecords);
+        ~StationWorker();
+
+        StationWorker(const StationWorker&) = delete;
+        StationWorker& operator=(const StationWorker&) = delete;
+
+        void setCaptureDir(const std::string& newCaptureDir);
+        void start();
+        void stop();
+
+        void deviceArrived(libusb_device *newDevice);
+        void deviceLeft(libusb_device *oldDevice);
+
+        std::string getStationId();
+
+        static std::string stationIdOf(libusb_device *dev);
+};
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file UsbFrameSource.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief UsbFrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The UsbFrameSource object provides the frames read from a real TE923
+ * station through a UsbSession.
+ */
+
+#include "UsbFrameSource.h"
+
+#include <ctime>
+
+/**
+ * @brief Construct a new UsbFrameSource object
+ *
+ * @param newSession Session with the station
+ */
+UsbFrameSource::UsbFrameSource(UsbSession *newSession) {
+    session = newSession;
+}
+
+/**
+ * @brief Read the current readings frame of the station
+ *
+ * @param receive_buffer Buffer where the frame is stored.
+ * @param timestamp Time when the frame was read.
+ * @return short int 0 if a frame was read, negative if the read failed.
+ */
+short int UsbFrameSource::readFrame(unsigned char* receive_buffer, unsigned int &timestamp) {
+    short int retValue;
+
+    retValue = session->readFrame(receive_buffer);
+    timestamp = std::time(nullptr);
+
+    return retValue;
+}
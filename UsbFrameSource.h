@@ -0,0 +1,40 @@
+/**
+ * @file UsbFrameSource.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief UsbFrameSource Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The UsbFrameSource object provides the frames read from a real TE923
+ * station through a UsbSession.
+ */
+
+#ifndef USBFRAMESOURCE_H
+#define USBFRAMESOURCE_H
+
+#include "FrameSource.h"
+#include "UsbSession.h"
+
+/**
+ * @brief UsbFrameSource Class
+ *
+ * Frame source reading the current readings of a station. The session is
+ * not owned by the source.
+ */
+class UsbFrameSource : public FrameSource
+{
+    /* UsbFrameSource attributes */
+    protected:
+        /// Session with the station.
+        UsbSession *session;
+
+    /* UsbFrameSource public methods */
+    public:
+        UsbFrameSource(UsbSession *newSession);
+
+        short int readFrame(unsigned char* receive_buffer, unsigned int &timestamp);
+};
+
+#endif
@@ -0,0 +1,666 @@
+/**
+ * @file UsbSession.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief UsbSession Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The UsbSession object keeps the libusb context and the handle of the TE923
+ * device open between acquisition cycles, so the whole init/open/claim/exit
+ * sequence is only repeated when a transfer with the device fails.
+ */
+
+#include "UsbSession.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "data_decoder.h"
+#include "main.h"
+#include "UsbTracer.h"
+
+using namespace std;
+
+/// Number of 8 bytes interrupt reports (7 data bytes each) needed for a frame.
+const int ASYNC_QUEUED_READS = (BUFLEN + 6) / 7;
+/// Timeout of each queued interrupt read, counted from its submission (ms).
+const unsigned int ASYNC_READ_TIMEOUT = 1000;
+
+/**
+ * @brief Completion state shared by the transfers of an asynchronous read
+ */
+struct AsyncRead {
+    /// Transfers submitted and not completed yet.
+    int pending;
+    /// Set when all the transfers are completed, to stop the event handling.
+    int completed;
+    /// Set when a transfer ends with an error other than a timeout.
+    bool failed;
+    /// Time when the transfers were submitted, for the tracer.
+    chrono::steady_clock::time_point start;
+    /// Time when the transfers were submitted, in microseconds since the epoch.
+    int64_t start_us;
+    /// Device of the transfers, for the tracer.
+    uint16_t device;
+    /// Memory address requested, for the tracer.
+    int control_addr;
+    /// Number of the exchange of the read, for the tracer.
+    int attempt;
+};
+
+/**
+ * @brief Record a transfer in the USB tracer
+ *
+ * @param kind Kind of the transfer
+ * @param device Device of the transfer
+ * @param control_addr Memory address requested
+ * @param attempt Number of the exchange of the read
+ * @param start_us Time when the transfer started, in microseconds since the epoch
+ * @param start Time when the transfer started
+ * @param bytes Number of bytes transferred
+ * @param status Result of the transfer
+ */
+static void trace_transfer(UsbTraceKind kind, uint16_t device, int control_addr, int attempt, int64_t start_us, chrono::steady_clock::time_point start, int bytes, int status)
+{
+    UsbTraceEntry entry;
+
+    entry.timestamp_us = start_us;
+    entry.duration_us = (uint32_t)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    entry.bytes = (uint16_t)(bytes < 0 ? 0 : bytes);
+    entry.device = device;
+    entry.address = (uint32_t)control_addr;
+    entry.status = (int16_t)status;
+    entry.kind = (uint8_t)kind;
+    entry.attempt = (uint8_t)attempt;
+    UsbTracer::instance().record(entry);
+}
+
+/**
+ * @brief Fill the request message for a memory address of the station
+ *
+ * @param control_data 8 bytes message to fill
+ * @param control_addr Memory address to read from the station
+ */
+static void fill_request(unsigned char* control_data, int control_addr)
+{
+    control_data[0] = 0x05;
+    control_data[1] = 0xAF;
+    control_data[4] = control_addr / 0x10000;
+    control_data[3] = ( control_addr - ( control_data[4] * 0x10000 ) ) / 0x100;
+    control_data[2] = control_addr - ( control_data[4] * 0x10000 ) - ( control_data[3] * 0x100 );
+    control_data[5] = ( control_data[1] ^ control_data[2] ^ control_data[3] ^ control_data[4] );
+    control_data[6] = 0xAF;
+    control_data[7] = 0xFE;
+}
+
+/**
+ * @brief Check the XOR CRC of a received frame
+ *
+ * @param receive_buffer Frame received from the station
+ * @return true The frame is valid
+ * @return false The CRC does not match
+ */
+static bool frame_crc_ok(unsigned char* receive_buffer)
+{
+    #ifdef DEBUG
+    unsigned char crc = 0x00;
+    for (int i = 0; i <= 32; i++ ) {
+        crc = crc ^ receive_buffer[i];
+    }
+    cout << "CRC: " << hex << (int)crc << dec << endl;
+    cout << "Rbuf[33]: " << hex << (int)receive_buffer[33] << dec << endl;
+    cout << "Rbuf[0]: " << hex << (int)receive_buffer[0] << dec << endl;
+    #endif
+
+    return check_crc(receive_buffer);
+}
+
+/**
+ * @brief Completion callback of the asynchronous transfers
+ *
+ * Timeouts are not considered errors: a queued read timing out only means
+ * that the station had nothing else to send. Every transfer is recorded in
+ * the USB tracer, timed from the submission of the exchange.
+ *
+ * @param transfer Transfer completed
+ */
+static void LIBUSB_CALL async_transfer_cb(libusb_transfer *transfer)
+{
+    AsyncRead *state = (AsyncRead*)transfer->user_data;
+
+    trace_transfer(transfer->type == LIBUSB_TRANSFER_TYPE_CONTROL ? USB_TRACE_ASYNC_CONTROL : USB_TRACE_ASYNC_INTERRUPT,
+                   state->device, state->control_addr, state->attempt, state->start_us, state->start,
+                   transfer->actual_length, transfer->status);
+
+    if (transfer->status != LIBUSB_TRANSFER_COMPLETED &&
+        transfer->status != LIBUSB_TRANSFER_TIMED_OUT &&
+        transfer->status != LIBUSB_TRANSFER_CANCELLED)
+        state->failed = true;
+
+    state->pending--;
+    if (state->pending == 0)
+        state->completed = 1;
+}
+
+/**
+ * @brief Construct a new UsbSession object
+ *
+ * Creates a new session for the default TE923 device. Nothing is opened
+ * until the first read is requested.
+ */
+UsbSession::UsbSession() {
+    ctx = NULL;
+    owns_ctx = true;
+    device = NULL;
+    dev_handle = NULL;
+    vendor_id = TE923_VENDOR_ID;
+    product_id = TE923_PRODUCT_ID;
+    async_mode = false;
+    capture_log = NULL;
+    response_delay = USB_RESPONSE_DELAY_INITIAL;
+    trace_device = 0;
+    trace_attempt = 0;
+}
+
+/**
+ * @brief Construct a new UsbSession object
+ *
+ * Creates a new session for the device with the indicated IDs. Nothing is
+ * opened until the first read is requested.
+ *
+ * @param newVendorId Vendor ID of the device
+ * @param newProductId Product ID of the device
+ */
+UsbSession::UsbSession(int newVendorId, int newProductId) {
+    ctx = NULL;
+    owns_ctx = true;
+    device = NULL;
+    dev_handle = NULL;
+    vendor_id = newVendorId;
+    product_id = newProductId;
+    async_mode = false;
+    capture_log = NULL;
+    response_delay = USB_RESPONSE_DELAY_INITIAL;
+    trace_device = 0;
+    trace_attempt = 0;
+}
+
+/**
+ * @brief Construct a new UsbSession object
+ *
+ * Creates a new session for an already enumerated device, using a libusb
+ * context owned by someone else (for example, the DeviceManager). The device
+ * is referenced until the session is destroyed.
+ *
+ * @param sharedCtx libusb context where the device was found
+ * @param newDevice Device to open
+ */
+UsbSession::UsbSession(libusb_context *sharedCtx, libusb_device *newDevice) {
+    ctx = sharedCtx;
+    owns_ctx = false;
+    device = libusb_ref_device(newDevice);
+    dev_handle = NULL;
+    vendor_id = TE923_VENDOR_ID;
+    product_id = TE923_PRODUCT_ID;
+    async_mode = false;
+    capture_log = NULL;
+    response_delay = USB_RESPONSE_DELAY_INITIAL;
+    trace_device = 0;
+    trace_attempt = 0;
+}
+
+/**
+ * @brief Destroy the UsbSession object
+ *
+ * Releases the device, if opened, and the libusb context if it is owned by
+ * the session.
+ */
+UsbSession::~UsbSession() {
+    close();
+    if (device != NULL) {
+        libusb_unref_device(device);
+        device = NULL;
+    }
+    if (ctx != NULL && owns_ctx) {
+        libusb_exit(ctx);
+        ctx = NULL;
+    }
+}
+
+/**
+ * @brief Open the device and claim its interface
+ *
+ * Initializes the libusb context if it does not exist yet, opens the device,
+ * detaches the kernel driver and claims the interface 0. If the session is
+ * already opened, nothing is done.
+ *
+ * @return short int Result of the execution of the function.
+ */
+short int UsbSession::open() {
+    libusb_device **devs;
+    int retValue;
+    int iInterface;
+    ssize_t counter;
+
+    if (dev_handle != NULL)
+        return 0;
+
+    if (ctx == NULL) {
+        retValue = libusb_init(&ctx);
+        if (retValue < 0) {
+            cerr << "Error initializing libusb" << endl;
+            ctx = NULL;
+            return -1;
+        }
+    }
+
+    #ifdef DEBUG
+    counter = libusb_get_device_list(ctx, &devs);
+    if (counter < 0) {
+        cerr << "Error listing the devices" << endl;
+    } else {
+        cout << "There are " << counter << " devices in the list" << endl;
+        for (int i = 0; i < counter; i++) {
+            printdev(devs[i]);
+        }
+        libusb_free_device_list(devs, 1);
+    }
+    #else
+    (void)devs;
+    (void)counter;
+    #endif
+
+    if (device != NULL) {
+        retValue = libusb_open(device, &dev_handle);
+        if (retValue < 0)
+            dev_handle = NULL;
+    } else {
+        dev_handle = libusb_open_device_with_vid_pid(ctx, vendor_id, product_id);
+    }
+    if (dev_handle == NULL) {
+        cerr << "Cannot open device" << endl;
+        return -2;
+    }
+    #ifdef DEBUG
+        cout << "Device opened" << endl;
+    #endif
+    trace_device = libusb_get_bus_number(libusb_get_device(dev_handle)) << 8 | libusb_get_device_address(libusb_get_device(dev_handle));
+
+    retValue = libusb_set_auto_detach_kernel_driver(dev_handle, 1);
+    if (retValue < 0) {
+        cerr << " Error auto-setting the kernel detach: " << libusb_strerror(libusb_error(retValue)) << endl;
+        if (libusb_kernel_driver_active(dev_handle, 0) == 1) {
+            cerr << "Kernel Driver Active" << endl;
+            if (libusb_detach_kernel_driver(dev_handle, 0) == 0) {
+                cerr << "Kernel Driver Detached" << endl;
+            } else {
+                cerr << "Error detaching the Kernel Driver" << endl;
+            }
+        } else {
+            cerr << "Kernel Driver not loaded" << endl;
+        }
+    }
+
+    iInterface = libusb_claim_interface(dev_handle, 0);
+    if (iInterface < 0) {
+        cerr << "Cannot Claim Interface (" << libusb_strerror(libusb_error(iInterface)) << ")" << endl;
+        libusb_close(dev_handle);
+        dev_handle = NULL;
+        return -3;
+    }
+    #ifdef DEBUG
+        cout << "Interface claimed" << endl;
+    #endif
+
+    retValue = libusb_set_interface_alt_setting(dev_handle, 0, 0);
+    if (retValue < 0) {
+        cerr << "Alternative setting not configured: " << libusb_strerror(libusb_error(retValue)) << endl;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Release the interface and close the device
+ *
+ * The libusb context is kept, so a later open() only has to reopen the
+ * device.
+ */
+void UsbSession::close() {
+    if (dev_handle != NULL) {
+        libusb_release_interface(dev_handle, 0);
+        libusb_close(dev_handle);
+        dev_handle = NULL;
+    }
+}
+
+/**
+ * @brief Check if the device is currently opened
+ *
+ * @return true The device is opened and claimed
+ * @return false The device is not opened
+ */
+bool UsbSession::isOpen() {
+    return dev_handle != NULL;
+}
+
+/**
+ * @brief Select the acquisition mode of the session
+ *
+ * @param newAsyncMode True to use the event-driven transfers, false to use
+ * the blocking ones.
+ */
+void UsbSession::setAsyncMode(bool newAsyncMode) {
+    async_mode = newAsyncMode;
+}
+
+/**
+ * @brief Select the log where the frames are captured
+ *
+ * Every current readings frame received (valid or not) is appended to the
+ * log, with the result of its CRC check.
+ *
+ * @param newCaptureLog Log to use, NULL to stop capturing
+ */
+void UsbSession::setCaptureLog(FrameLog *newCaptureLog) {
+    capture_log = newCaptureLog;
+}
+
+/**
+ * @brief Function to obtain the info from the USB device
+ *
+ * Reads the current values frame from the station, using the acquisition mode
+ * selected in the session.
+ *
+ * @param receive_buffer Buffer where the retreived information is stored.
+ * @return short int Result of the execution of the function.
+ */
+short int UsbSession::readFrame(unsigned char* receive_buffer)
+{
+    return readAddress(TE923_CURRENT_ADDR, receive_buffer);
+}
+
+/**
+ * @brief Function to read a block of the station memory
+ *
+ * Reads the block starting at the indicated address as a transaction of
+ * request/response exchanges, using the acquisition mode selected in the
+ * session. A short answer is completed requesting only the missing bytes,
+ * and a frame with a bad CRC is requested again (and repaired from the
+ * previous ones if they keep failing), waiting more between the retries
+ * while they keep failing. If any transfer fails the device is closed so the
+ * next read reconnects.
+ *
+ * @param control_addr Memory address to read from the station
+ * @param receive_buffer Buffer where the retreived information is stored.
+ * @return short int Result of the execution of the function.
+ */
+short int UsbSession::readAddress(int control_addr, unsigned char* receive_buffer)
+{
+    int retValue;
+    int offset;
+    int bytes_received;
+    bool complete_frame;
+    chrono::steady_clock::time_point start;
+
+    retValue = open();
+    if (retValue < 0)
+        return retValue;
+
+    transaction.reset(receive_buffer);
+
+    while (transaction.getState() == TRANSACTION_REQUEST) {
+        this_thread::sleep_for(transaction.getRetryDelay());
+
+        offset = transaction.getNextOffset();
+        bytes_received = 0;
+        trace_attempt = transaction.getAttempts().size() + 1;
+        start = chrono::steady_clock::now();
+        if (async_mode)
+            retValue = requestBlockAsync(control_addr + offset, transaction.getBuffer(), transaction.getBufferSize(), bytes_received);
+        else
+            retValue = requestBlockSync(control_addr + offset, transaction.getBuffer(), transaction.getBufferSize(), bytes_received);
+        if (retValue < 0) {
+            close();
+            return -4;
+        }
+        transaction.completeAttempt(bytes_received, chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start));
+
+        // Adapt the wait for the answer of the blocking mode
+        if (transaction.getAttempts().back().outcome == ATTEMPT_EMPTY || transaction.getAttempts().back().outcome == ATTEMPT_SHORT) {
+            response_delay = response_delay * 2;
+            if (response_delay > USB_RESPONSE_DELAY_MAX)
+                response_delay = USB_RESPONSE_DELAY_MAX;
+        } else if (transaction.getAttempts().size() == 1 && transaction.getState() == TRANSACTION_DONE) {
+            response_delay = response_delay * 3 / 4;
+            if (response_delay < USB_RESPONSE_DELAY_MIN)
+                response_delay = USB_RESPONSE_DELAY_MIN;
+        }
+
+        complete_frame = offset + bytes_received >= TRANSACTION_CHECKED_LEN;
+        if (capture_log != NULL && control_addr == TE923_CURRENT_ADDR && complete_frame)
+            capture_log->append(receive_buffer, frame_crc_ok(receive_buffer));
+    }
+
+    if (transaction.getState() != TRANSACTION_DONE)
+        return -5;
+
+    return 0;
+}
+
+/**
+ * @brief Get the record of the exchanges of the last read
+ *
+ * @return const std::vector<TransactionAttempt>& Exchanges of the last read
+ */
+const vector<TransactionAttempt>& UsbSession::getLastAttempts() {
+    return transaction.getAttempts();
+}
+
+/**
+ * @brief Function to request a block to the USB device with blocking calls
+ *
+ * Through this function, via the libusb, a dump signal is sent to the device
+ * of the session. After that, the USB device returns a message with the
+ * information related to the Weather Station, coded into an array of
+ * unsigned chars. The reports are read until the station stops sending them,
+ * and their data is copied in order into the buffer.
+ *
+ * @param control_addr Memory address to read from the station
+ * @param receive_buffer Buffer where the retreived information is stored.
+ * @param buffer_size Maximum number of bytes to store.
+ * @param total_transferred Number of bytes stored.
+ * @return short int Result of the execution of the function.
+ */
+short int UsbSession::requestBlockSync(int control_addr, unsigned char* receive_buffer, int buffer_size, int &total_transferred)
+{
+    int retValue;
+    unsigned char control_data[8];
+    int transferred_len = 0;
+    int bytes_transferred = 0;
+    chrono::steady_clock::time_point start;
+    int64_t start_us;
+
+    total_transferred = 0;
+
+    // Control transferece
+    fill_request(control_data, control_addr);
+
+    start = chrono::steady_clock::now();
+    start_us = UsbTracer::now();
+    retValue = libusb_control_transfer(dev_handle, 0x21 & 0xff, 0x09 & 0xff, 0x0200 & 0xffff, 0x0000 & 0xffff, control_data, 0x08 & 0xffff, 50);
+    trace_transfer(USB_TRACE_CONTROL, trace_device, control_addr, trace_attempt, start_us, start, retValue < 0 ? 0 : retValue, retValue < 0 ? retValue : 0);
+    if (retValue < 0) {
+        cerr << "Error sending request: " << libusb_strerror(libusb_error(retValue)) << endl;
+        if (retValue != LIBUSB_ERROR_TIMEOUT) {
+            cerr << "Transfer failed, closing the device" << endl;
+            return -4;
+        }
+    } else {
+        std::this_thread::sleep_for(response_delay);
+        #ifdef DEBUG
+            cout << "Message sent" << endl;
+        #endif
+    }
+
+    // Receive transference
+    start = chrono::steady_clock::now();
+    start_us = UsbTracer::now();
+    retValue = libusb_interrupt_transfer(dev_handle, 0x81 & 0xff, control_data, 0x8, &transferred_len, 50);
+    trace_transfer(USB_TRACE_INTERRUPT, trace_device, control_addr, trace_attempt, start_us, start, transferred_len, retValue);
+    while (retValue >= 0 || retValue == LIBUSB_ERROR_TIMEOUT) {
+        if (transferred_len <= 0)
+            return 0;
+        bytes_transferred = (int)(control_data[0]);
+        #ifdef DEBUG
+        cout << "Control data 0: " << hex << (int)(control_data[0]) << dec << endl;
+        cout << "Data transferred: " << transferred_len << endl;
+        #endif
+        if (bytes_transferred > transferred_len - 1)
+            bytes_transferred = transferred_len - 1;
+        if (bytes_transferred > buffer_size - total_transferred)
+            bytes_transferred = buffer_size - total_transferred;
+        memcpy(receive_buffer + total_transferred, control_data + 1, bytes_transferred);
+        total_transferred += bytes_transferred;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        transferred_len = 0;
+        start = chrono::steady_clock::now();
+        start_us = UsbTracer::now();
+        retValue = libusb_interrupt_transfer(dev_handle, 0x81 & 0xff, control_data, 0x8, &transferred_len, 50);
+        trace_transfer(USB_TRACE_INTERRUPT, trace_device, control_addr, trace_attempt, start_us, start, transferred_len, retValue);
+    }
+
+    cerr << "Error in the receive transfer (" << libusb_strerror(libusb_error(retValue)) << "), closing the device" << endl;
+    return -4;
+}
+
+/**
+ * @brief Function to request a block to the USB device with async transfers
+ *
+ * All the interrupt reads needed for a frame are queued before the request is
+ * sent, and the libusb events are handled until every transfer is completed.
+ * This way the frame is available as soon as the station answers, instead of
+ * after the fixed waits of the blocking mode.
+ *
+ * @param control_addr Memory address to read from the station
+ * @param receive_buffer Buffer where the retreived information is stored.
+ * @param buffer_size Maximum number of bytes to store.
+ * @param total_transferred Number of bytes stored.
+ * @return short int Result of the execution of the function.
+ */
+short int UsbSession::requestBlockAsync(int control_addr, unsigned char* receive_buffer, int buffer_size, int &total_transferred)
+{
+    libusb_transfer *control_transfer;
+    libusb_transfer *read_transfers[ASYNC_QUEUED_READS];
+    unsigned char control_buffer[LIBUSB_CONTROL_SETUP_SIZE + 8];
+    unsigned char read_buffers[ASYNC_QUEUED_READS][8];
+    AsyncRead state;
+    int retValue;
+    int bytes_transferred;
+    bool cancelled = false;
+
+    total_transferred = 0;
+    state.pending = 0;
+    state.completed = 0;
+    state.failed = false;
+    state.start = chrono::steady_clock::now();
+    state.start_us = UsbTracer::now();
+    state.device = trace_device;
+    state.control_addr = control_addr;
+    state.attempt = trace_attempt;
+
+    control_transfer = libusb_alloc_transfer(0);
+    for (int i = 0; i < ASYNC_QUEUED_READS; i++)
+        read_transfers[i] = libusb_alloc_transfer(0);
+
+    if (control_transfer == NULL)
+        state.failed = true;
+
+    // Queue the reads first, so no report is missed
+    for (int i = 0; i < ASYNC_QUEUED_READS && !state.failed; i++) {
+        if (read_transfers[i] == NULL) {
+            state.failed = true;
+            break;
+        }
+        libusb_fill_interrupt_transfer(read_transfers[i], dev_handle, 0x81 & 0xff, read_buffers[i], 0x8, async_transfer_cb, &state, ASYNC_READ_TIMEOUT);
+        read_transfers[i]->actual_length = 0;
+        retValue = libusb_submit_transfer(read_transfers[i]);
+        if (retValue < 0) {
+            cerr << "Error queueing the receive transfer: " << libusb_strerror(libusb_error(retValue)) << endl;
+            state.failed = true;
+            break;
+        }
+        state.pending++;
+    }
+
+    // Control transferece
+    if (!state.failed) {
+        libusb_fill_control_setup(control_buffer, 0x21 & 0xff, 0x09 & 0xff, 0x0200 & 0xffff, 0x0000 & 0xffff, 0x08 & 0xffff);
+        fill_request(control_buffer + LIBUSB_CONTROL_SETUP_SIZE, control_addr);
+        libusb_fill_control_transfer(control_transfer, dev_handle, control_buffer, async_transfer_cb, &state, 50);
+        retValue = libusb_submit_transfer(control_transfer);
+        if (retValue < 0) {
+            cerr << "Error sending request: " << libusb_strerror(libusb_error(retValue)) << endl;
+            state.failed = true;
+        } else {
+            state.pending++;
+        }
+    }
+
+    // Event handling until every transfer is completed or cancelled
+    while (state.pending > 0) {
+        if (state.failed && !cancelled) {
+            for (int i = 0; i < ASYNC_QUEUED_READS; i++) {
+                if (read_transfers[i] != NULL)
+                    libusb_cancel_transfer(read_transfers[i]);
+            }
+            libusb_cancel_transfer(control_transfer);
+            cancelled = true;
+        }
+
+        timeval tv = {0, 100000};
+        retValue = libusb_handle_events_timeout_completed(ctx, &tv, &state.completed);
+        if (retValue < 0 && retValue != LIBUSB_ERROR_INTERRUPTED) {
+            cerr << "Error handling the USB events: " << libusb_strerror(libusb_error(retValue)) << endl;
+            state.failed = true;
+        }
+    }
+
+    if (!state.failed) {
+        #ifdef DEBUG
+            cout << "Message sent" << endl;
+        #endif
+
+        // Frame assembly, in the order the reports were received
+        for (int i = 0; i < ASYNC_QUEUED_READS; i++) {
+            if (read_transfers[i]->status != LIBUSB_TRANSFER_COMPLETED || read_transfers[i]->actual_length <= 0)
+                break;
+            bytes_transferred = (int)(read_buffers[i][0]);
+            if (bytes_transferred > read_transfers[i]->actual_length - 1)
+                bytes_transferred = read_transfers[i]->actual_length - 1;
+            if (bytes_transferred > buffer_size - total_transferred)
+                bytes_transferred = buffer_size - total_transferred;
+            memcpy(receive_buffer + total_transferred, read_buffers[i] + 1, bytes_transferred);
+            total_transferred += bytes_transferred;
+        }
+        #ifdef DEBUG
+        cout << "Message received (" << total_transferred << " bytes)" << endl;
+        #endif
+    }
+
+    libusb_free_transfer(control_transfer);
+    for (int i = 0; i < ASYNC_QUEUED_READS; i++)
+        libusb_free_transfer(read_transfers[i]);
+
+    if (state.failed) {
+        cerr << "Transfer failed, closing the device" << endl;
+        return -4;
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file UsbSession.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief UsbSession Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The UsbSession object keeps the libusb context and the handle of the TE923
+ * device open between acquisition cycles, so the whole init/open/claim/exit
+ * sequence is only repeated when a transfer with the device fails.
+ */
+
+#ifndef USBSESSION_H
+#define USBSESSION_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <libusb-1.0/libusb.h>
+
+#include "FrameLog.h"
+#include "FrameTransaction.h"
+
+/// Vendor ID of the TE923 compatible weather stations.
+const int TE923_VENDOR_ID = 4400;
+/// Product ID of the TE923 compatible weather stations.
+const int TE923_PRODUCT_ID = 26625;
+/// Memory address of the current readings block of the station.
+const int TE923_CURRENT_ADDR = 0x020001;
+/// Initial wait for the answer of the station in the blocking mode.
+const std::chrono::milliseconds USB_RESPONSE_DELAY_INITIAL(300);
+/// Minimum wait for the answer of the station in the blocking mode.
+const std::chrono::milliseconds USB_RESPONSE_DELAY_MIN(50);
+/// Maximum wait for the answer of the station in the blocking mode.
+const std::chrono::milliseconds USB_RESPONSE_DELAY_MAX(1000);
+
+/**
+ * @brief UsbSession Class
+ *
+ * Long-lived session with a TE923 device. The libusb context is created once
+ * and the device is opened and claimed on the first read. The handle is kept
+ * across reads and it is only released (and reopened in the next read) when
+ * a transfer fails, so each acquisition cycle only pays for the transfers.
+ * Each read is a FrameTransaction, so short or corrupt answers are completed
+ * or repaired without repeating the whole exchange. Every transfer is recorded
+ * in the UsbTracer of the program.
+ */
+class UsbSession
+{
+    /* UsbSession attributes */
+    protected:
+        /// libusb context used by the session.
+        libusb_context *ctx;
+        /// The context is created by the session and released with it.
+        bool owns_ctx;
+        /// Device to open (NULL to open the first one matching the IDs).
+        libusb_device *device;
+        /// Handle of the opened device (NULL while disconnected).
+        libusb_device_handle *dev_handle;
+        /// Vendor ID of the device to open.
+        int vendor_id;
+        /// Product ID of the device to open.
+        int product_id;
+        /// Use the event-driven transfers instead of the blocking ones.
+        bool async_mode;
+        /// Log where the current readings frames are captured (NULL if none).
+        FrameLog *capture_log;
+        /// Wait for the answer of the station in the blocking mode, adapted
+        /// to how the station answered the last requests.
+        std::chrono::milliseconds response_delay;
+        /// Transaction of the last read.
+        FrameTransaction transaction;
+        /// Device of the session as recorded in the USB tracer.
+        uint16_t trace_device;
+        /// Number of the exchange in progress, as recorded in the USB tracer.
+        int trace_attempt;
+
+        short int requestBlockSync(int control_addr, unsigned char* receive_buffer, int buffer_size, int &total_transferred);
+        short int requestBlockAsync(int control_addr, unsigned char* receive_buffer, int buffer_size, int &total_transferred);
+
+    /* UsbSession public methods */
+    public:
+        UsbSession();
+        UsbSession(int newVendorId, int newProductId);
+        UsbSession(libusb_context *sharedCtx, libusb_device *newDevice);
+        ~UsbSession();
+
+        UsbSession(const UsbSession&) = delete;
+        UsbSession& operator=(const UsbSession&) = delete;
+
+        short int open();
+        void close();
+        bool isOpen();
+        void setAsyncMode(bool newAsyncMode);
+        void setCaptureLog(FrameLog *newCaptureLog);
+
+        short int readFrame(unsigned char* receive_buffer);
+        short int readAddress(int control_addr, unsigned char* receive_buffer);
+        const std::vector<TransactionAttempt>& getLastAttempts();
+};
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file UsbTracer.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief UsbTracer Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The UsbTracer object records every USB transfer made with the stations in
+ * an in-memory ring, so the time spent in each cycle can be inspected on a
+ * running program without rebuilding it in DEBUG mode.
+ */
+
+#include "UsbTracer.h"
+
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <pthread.h>
+#include <thread>
+#include <libusb-1.0/libusb.h>
+
+using namespace std;
+
+/// Names of the libusb transfer status values, for the asynchronous transfers.
+static const char* TRANSFER_STATUS_NAMES[] = {
+    "COMPLETED", "ERROR", "TIMED_OUT", "CANCELLED", "STALL", "NO_DEVICE", "OVERFLOW"
+};
+
+/// Names of the kinds of transfer.
+static const char* TRACE_KIND_NAMES[] = {
+    "control", "interrupt", "async-control", "async-interrupt"
+};
+
+/**
+ * @brief Construct a new UsbTracer object
+ *
+ * The ring starts empty.
+ */
+UsbTracer::UsbTracer() {
+    for (unsigned int i = 0; i < USB_TRACE_SIZE; i++)
+        slots[i].seq.store(0, memory_order_relaxed);
+    head.store(0, memory_order_relaxed);
+}
+
+/**
+ * @brief Record a transfer in the ring
+ *
+ * Overwrites the oldest entry when the ring is full. It never blocks.
+ *
+ * @param entry Transfer to record
+ */
+void UsbTracer::record(const UsbTraceEntry& entry) {
+    uint64_t position = head.fetch_add(1, memory_order_relaxed);
+    Slot &slot = slots[position & (USB_TRACE_SIZE - 1)];
+
+    slot.seq.store(2 * position + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot.timestamp.store((uint64_t)entry.timestamp_us, memory_order_relaxed);
+    slot.timing.store((uint64_t)entry.duration_us << 32 | (uint64_t)entry.bytes << 16 | entry.device, memory_order_relaxed);
+    slot.result.store((uint64_t)entry.address << 32 | (uint64_t)(uint16_t)entry.status << 16 | (uint64_t)entry.kind << 8 | entry.attempt, memory_order_relaxed);
+
+    slot.seq.store(2 * position + 2, memory_order_release);
+}
+
+/**
+ * @brief Copy the entries of the ring
+ *
+ * The entries being written while they are copied are skipped.
+ *
+ * @return std::vector<UsbTraceEntry> Entries, from the oldest to the newest
+ */
+vector<UsbTraceEntry> UsbTracer::snapshot() {
+    vector<UsbTraceEntry> entries;
+    UsbTraceEntry entry;
+    uint64_t last = head.load(memory_order_acquire);
+    uint64_t first = last > USB_TRACE_SIZE ? last - USB_TRACE_SIZE : 0;
+    uint64_t seq;
+    uint64_t timing;
+    uint64_t result;
+
+    entries.reserve(last - first);
+    for (uint64_t position = first; position < last; position++) {
+        Slot &slot = slots[position & (USB_TRACE_SIZE - 1)];
+
+        seq = slot.seq.load(memory_order_acquire);
+        if (seq != 2 * position + 2)
+            continue;
+
+        entry.timestamp_us = (int64_t)slot.timestamp.load(memory_order_relaxed);
+        timing = slot.timing.load(memory_order_relaxed);
+        result = slot.result.load(memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (slot.seq.load(memory_order_relaxed) != seq)
+            continue;
+
+        entry.duration_us = (uint32_t)(timing >> 32);
+        entry.bytes = (uint16_t)(timing >> 16);
+        entry.device = (uint16_t)timing;
+        entry.address = (uint32_t)(result >> 32);
+        entry.status = (int16_t)(uint16_t)(result >> 16);
+        entry.kind = (uint8_t)(result >> 8);
+        entry.attempt = (uint8_t)result;
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+/**
+ * @brief Write the entries of the ring, one per line
+ *
+ * @param out Stream where the entries are written
+ */
+void UsbTracer::dump(ostream& out) {
+    vector<UsbTraceEntry> entries = snapshot();
+
+    out << "USB trace: " << entries.size() << " of " << getCount() << " transfers" << endl;
+    for (auto &entry : entries) {
+        out << entry.timestamp_us / 1000000 << "." << setfill('0') << setw(6) << entry.timestamp_us % 1000000 << setfill(' ')
+            << " " << (entry.device >> 8) << ":" << (entry.device & 0xff)
+            << " " << (entry.kind <= USB_TRACE_ASYNC_INTERRUPT ? TRACE_KIND_NAMES[entry.kind] : "?")
+            << " addr=0x" << hex << entry.address << dec
+            << " attempt=" << (int)entry.attempt
+            << " bytes=" << entry.bytes
+            << " time=" << entry.duration_us << "us status=";
+        if (entry.kind == USB_TRACE_ASYNC_CONTROL || entry.kind == USB_TRACE_ASYNC_INTERRUPT) {
+            if (entry.status >= 0 && entry.status <= LIBUSB_TRANSFER_OVERFLOW)
+                out << TRANSFER_STATUS_NAMES[entry.status];
+            else
+                out << entry.status;
+        } else {
+            out << libusb_error_name(entry.status);
+        }
+        out << endl;
+    }
+}
+
+/**
+ * @brief Get the number of transfers recorded since the start
+ *
+ * @return uint64_t Transfers recorded, including the ones overwritten
+ */
+uint64_t UsbTracer::getCount() {
+    return head.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Get the current time, as stored in the entries
+ *
+ * @return int64_t Microseconds since the epoch
+ */
+int64_t UsbTracer::now() {
+    return chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Get the tracer of the program
+ *
+ * @return UsbTracer& Tracer where every session records its transfers
+ */
+UsbTracer& UsbTracer::instance() {
+    static UsbTracer tracer;
+    return tracer;
+}
+
+/**
+ * @brief Dump the tracer of the program to stderr each time a signal arrives
+ *
+ * The signal is blocked and waited for in a dedicated thread, so the dump is
+ * not made from a signal handler. It has to be called before any other
+ * thread is started, so all of them inherit the blocked signal.
+ *
+ * @param signum Signal that requests the dump (for example, SIGUSR1)
+ * @return short int Result of the execution of the function.
+ */
+short int UsbTracer::dumpOnSignal(int signum) {
+    sigset_t signals;
+
+    sigemptyset(&signals);
+    sigaddset(&signals, signum);
+    if (pthread_sigmask(SIG_BLOCK, &signals, NULL) != 0) {
+        cerr << "Cannot block the signal " << signum << endl;
+        return -1;
+    }
+
+    instance();
+    thread([signals]() {
+        int received;
+        while (sigwait(&signals, &received) == 0)
+            instance().dump(cerr);
+    }).detach();
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file UsbTracer.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief UsbTracer Class
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The UsbTracer object records every USB transfer made with the stations in
+ * an in-memory ring, so the time spent in each cycle can be inspected on a
+ * running program without rebuilding it in DEBUG mode.
+ */
+
+#ifndef USBTRACER_H
+#define USBTRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/// Number of transfers kept in the ring (a power of 2).
+const unsigned int USB_TRACE_SIZE = 1024;
+
+/// Kind of a traced transfer.
+enum UsbTraceKind {
+    /// Blocking control transfer (status is a libusb error code).
+    USB_TRACE_CONTROL,
+    /// Blocking interrupt transfer (status is a libusb error code).
+    USB_TRACE_INTERRUPT,
+    /// Asynchronous control transfer (status is a libusb transfer status).
+    USB_TRACE_ASYNC_CONTROL,
+    /// Asynchronous interrupt transfer (status is a libusb transfer status).
+    USB_TRACE_ASYNC_INTERRUPT
+};
+
+/**
+ * @brief Record of a traced transfer
+ */
+struct UsbTraceEntry {
+    /// Time when the transfer started, in microseconds since the epoch.
+    int64_t timestamp_us;
+    /// Time spent in the transfer, in microseconds.
+    uint32_t duration_us;
+    /// Number of bytes transferred.
+    uint16_t bytes;
+    /// Device of the transfer (bus number * 256 + device address).
+    uint16_t device;
+    /// Memory address of the station requested.
+    uint32_t address;
+    /// Result of the transfer.
+    int16_t status;
+    /// Kind of the transfer (UsbTraceKind).
+    uint8_t kind;
+    /// Number of the exchange of the read the transfer belongs to.
+    uint8_t attempt;
+};
+
+/**
+ * @brief UsbTracer Class
+ *
+ * Fixed ring of the last USB_TRACE_SIZE transfers. Any thread can record a
+ * transfer without locking: it reserves a position with an atomic counter
+ * and writes the entry protected by a sequence number, so a reader copying
+ * the ring at the same time skips the entries being written instead of
+ * blocking the writers. Recording costs a few atomic stores, and nothing
+ * else happens until someone reads the ring.
+ */
+class UsbTracer
+{
+    /**
+     * @brief Position of the ring
+     *
+     * The entry is packed in three words so it can be stored with atomic
+     * operations. The sequence number is odd while the entry is written.
+     */
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        std::atomic<uint64_t> timestamp;
+        std::atomic<uint64_t> timing;
+        std::atomic<uint64_t> result;
+    };
+
+    /* UsbTracer attributes */
+    protected:
+        /// Positions of the ring.
+        Slot slots[USB_TRACE_SIZE];
+        /// Number of transfers recorded since the start.
+        std::atomic<uint64_t> head;
+
+    /* UsbTracer public methods */
+    public:
+        UsbTracer();
+
+        UsbTracer(const UsbTracer&) = delete;
+        UsbTracer& operator=(const UsbTracer&) = delete;
+
+        void record(const UsbTraceEntry& entry);
+        std::vector<UsbTraceEntry> snapshot();
+        void dump(std::ostream& out);
+        uint64_t getCount();
+
+        static int64_t now();
+        static UsbTracer& instance();
+        static short int dumpOnSignal(int signum);
+};
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * @file batch_decoder.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Library to decode many frames at once
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Batch version of decode_frame(), for the replays, the history recoveries
+ * and any other place where thousands of frames are decoded together. The
+ * values are written in columns, one array per field.
+ *
+ * On x86 the frames are decoded in blocks of 16: the bytes of the block are
+ * transposed into columns, the BCD nibbles of the 16 frames are unpacked and
+ * validated together with SSE2, and the values are converted with SSE2 (or
+ * AVX2, when built with -mavx2) in double precision, following the same
+ * operations as decode_frame() so the results are identical. The remaining
+ * frames, and every frame on other architectures, use decode_frame().
+ */
+
+#include "batch_decoder.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Decode a range of frames with decode_frame()
+ *
+ * @param frames Frames of the batch
+ * @param start First frame to decode
+ * @param end Frame after the last one to decode
+ * @param columns Columns where the values are stored
+ */
+static void decode_range(const RawFrame* frames, size_t start, size_t end, const DecodedColumns& columns)
+{
+    DecodedFrame decoded;
+
+    for (size_t f = start; f < end; f++) {
+        decoded = decode_frame(frames[f]);
+        for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+            columns.temperature[i][f] = decoded.temperature[i];
+            columns.humidity[i][f] = decoded.humidity[i];
+        }
+        columns.pressure[f] = decoded.pressure;
+        columns.wind_chill[f] = decoded.wind_chill;
+        columns.wind_gust[f] = decoded.wind_gust;
+        columns.wind_speed[f] = decoded.wind_speed;
+        columns.wind_dir[f] = decoded.wind_dir;
+        columns.uv[f] = decoded.uv;
+        columns.rain[f] = decoded.rain;
+        columns.valid[f] = decoded.valid;
+        columns.status[f] = decoded.status;
+    }
+}
+
+#if defined(__SSE2__)
+
+/// Number of frames unpacked together.
+const int BATCH_BLOCK = 16;
+
+/**
+ * @brief Unpacked temperature fields of a block (also used for wind chill and UV)
+ */
+struct TemperatureColumns {
+    /// BCD value of the tenths and units byte.
+    alignas(16) int32_t value[BATCH_BLOCK];
+    /// Tens digit.
+    alignas(16) int32_t tens[BATCH_BLOCK];
+    /// 1 if 0.05 has to be added.
+    alignas(16) int32_t half[BATCH_BLOCK];
+    /// 1 if the value is negative.
+    alignas(16) int32_t negative[BATCH_BLOCK];
+    /// 1 if the value is available.
+    alignas(16) int32_t ok[BATCH_BLOCK];
+};
+
+/**
+ * @brief Unpacked wind gust or speed fields of a block
+ */
+struct WindColumns {
+    /// BCD value of the tenths and units byte.
+    alignas(16) int32_t value[BATCH_BLOCK];
+    /// Tens digit.
+    alignas(16) int32_t tens[BATCH_BLOCK];
+    /// 100 if the value is over 100 mph, else 0.
+    alignas(16) int32_t offset[BATCH_BLOCK];
+    /// 1 if the value is available.
+    alignas(16) int32_t ok[BATCH_BLOCK];
+};
+
+/**
+ * @brief Unpacked fields of a block of frames
+ */
+struct BlockColumns {
+    TemperatureColumns temperature[TE923_FRAME_SENSORS];
+    alignas(16) int32_t humidity[TE923_FRAME_SENSORS][BATCH_BLOCK];
+    alignas(16) int32_t humidity_ok[TE923_FRAME_SENSORS][BATCH_BLOCK];
+    alignas(16) int32_t pressure[BATCH_BLOCK];
+    alignas(16) int32_t pressure_ok[BATCH_BLOCK];
+    TemperatureColumns wind_chill;
+    WindColumns wind_gust;
+    WindColumns wind_speed;
+    alignas(16) int32_t wind_dir[BATCH_BLOCK];
+    alignas(16) int32_t wind_dir_ok[BATCH_BLOCK];
+    TemperatureColumns uv;
+    alignas(16) int32_t rain[BATCH_BLOCK];
+};
+
+/**
+ * @brief Load a byte of each frame of a block
+ *
+ * @param frames First frame of the block
+ * @param pos Position of the byte in the frames
+ * @return __m128i The byte of each of the 16 frames
+ */
+static inline __m128i gather_column(const RawFrame* frames, int pos)
+{
+    alignas(16) uint8_t column[BATCH_BLOCK];
+
+    for (int f = 0; f < BATCH_BLOCK; f++)
+        column[f] = frames[f][pos];
+
+    return _mm_load_si128((const __m128i*)column);
+}
+
+/**
+ * @brief Store 16 unsigned 16 bits values as 32 bits integers
+ *
+ * @param dst Array of 16 integers
+ * @param first Values of the frames 0 to 7
+ * @param second Values of the frames 8 to 15
+ */
+static inline void store_words(int32_t* dst, __m128i first, __m128i second)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    _mm_store_si128((__m128i*)dst, _mm_unpacklo_epi16(first, zero));
+    _mm_store_si128((__m128i*)(dst + 4), _mm_unpackhi_epi16(first, zero));
+    _mm_store_si128((__m128i*)(dst + 8), _mm_unpacklo_epi16(second, zero));
+    _mm_store_si128((__m128i*)(dst + 12), _mm_unpackhi_epi16(second, zero));
+}
+
+/**
+ * @brief Store 16 unsigned bytes as 32 bits integers
+ *
+ * @param dst Array of 16 integers
+ * @param bytes Byte of each frame
+ */
+static inline void store_bytes(int32_t* dst, __m128i bytes)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    store_words(dst, _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero));
+}
+
+/**
+ * @brief Store 16 byte masks as integers 0 or 1
+ *
+ * @param dst Array of 16 integers
+ * @param mask 0xFF or 0x00 for each frame
+ */
+static inline void store_flags(int32_t* dst, __m128i mask)
+{
+    store_bytes(dst, _mm_and_si128(mask, _mm_set1_epi8(1)));
+}
+
+static inline __m128i low_nibble(__m128i bytes)
+{
+    return _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
+}
+
+static inline __m128i high_nibble(__m128i bytes)
+{
+    return _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+}
+
+/**
+ * @brief Value of each byte read as two BCD digits (high * 10 + low)
+ */
+static inline __m128i bcd_values(__m128i bytes)
+{
+    __m128i high = high_nibble(bytes);
+
+    return _mm_add_epi8(_mm_add_epi8(_mm_slli_epi16(high, 3), _mm_slli_epi16(high, 1)), low_nibble(bytes));
+}
+
+/**
+ * @brief Mask of the nibbles that are valid BCD digits
+ */
+static inline __m128i digit_valid(__m128i nibbles)
+{
+    return _mm_cmplt_epi8(nibbles, _mm_set1_epi8(10));
+}
+
+/**
+ * @brief Mask of the bytes with both nibbles valid BCD digits
+ */
+static inline __m128i bcd_valid(__m128i bytes)
+{
+    return _mm_and_si128(digit_valid(low_nibble(bytes)), digit_valid(high_nibble(bytes)));
+}
+
+static inline __m128i bit_set(__m128i bytes, char bit)
+{
+    return _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(bit)), _mm_set1_epi8(bit));
+}
+
+static inline __m128i bit_clear(__m128i bytes, char bit)
+{
+    return _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(bit)), _mm_setzero_si128());
+}
+
+static inline __m128i equals(__m128i bytes, char value)
+{
+    return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(value));
+}
+
+/**
+ * @brief Unpack a temperature field (BCD tenths and units, flags and tens)
+ *
+ * @param columns Columns where the field is stored
+ * @param digits Byte with the tenths and units
+ * @param flags Byte with the flags and the tens
+ * @param ok Mask of the frames where the value is available
+ */
+static inline void unpack_temperature(TemperatureColumns& columns, __m128i digits, __m128i flags, __m128i ok)
+{
+    store_bytes(columns.value, bcd_values(digits));
+    store_bytes(columns.tens, low_nibble(flags));
+    store_flags(columns.half, bit_set(flags, 0x20));
+    store_flags(columns.negative, bit_clear(flags, (char)0x80));
+    store_flags(columns.ok, ok);
+}
+
+/**
+ * @brief Unpack a wind field (BCD tenths and units, flags and tens)
+ *
+ * @param columns Columns where the field is stored
+ * @param digits Byte with the tenths and units
+ * @param flags Byte with the flags and the tens
+ * @param ok Mask of the frames where the value is available
+ */
+static inline void unpack_wind(WindColumns& columns, __m128i digits, __m128i flags, __m128i ok)
+{
+    store_bytes(columns.value, bcd_values(digits));
+    store_bytes(columns.tens, low_nibble(flags));
+    store_bytes(columns.offset, _mm_and_si128(bit_set(flags, 0x10), _mm_set1_epi8(100)));
+    store_flags(columns.ok, ok);
+}
+
+/**
+ * @brief Transpose and unpack the BCD fields of a block of frames
+ *
+ * @param frames First frame of the block
+ * @param block Columns where the fields are stored
+ */
+static void unpack_block(const RawFrame* frames, BlockColumns& block)
+{
+    __m128i digits, flags, humidity, low, lost;
+    __m128i gust, gust_flags, gust_ok, speed, speed_flags, speed_ok;
+
+    /* Temperature and humidity of each channel */
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        digits = gather_column(frames, TE923Layout::TEMPERATURE + i * TE923Layout::SENSOR_STRIDE);
+        flags = gather_column(frames, TE923Layout::TEMPERATURE + i * TE923Layout::SENSOR_STRIDE + 1);
+        humidity = gather_column(frames, TE923Layout::HUMIDITY + i * TE923Layout::SENSOR_STRIDE);
+
+        low = low_nibble(digits);
+        lost = _mm_or_si128(equals(low, 0x0B), equals(low, 0x0C));
+        if (i > 0)
+            lost = _mm_or_si128(lost, bit_clear(flags, 0x40));
+
+        unpack_temperature(block.temperature[i], digits, flags, _mm_andnot_si128(lost, digit_valid(low)));
+        store_bytes(block.humidity[i], bcd_values(humidity));
+        store_flags(block.humidity_ok[i], _mm_andnot_si128(lost, digit_valid(low_nibble(humidity))));
+    }
+
+    /* Pressure */
+    digits = gather_column(frames, TE923Layout::PRESSURE);
+    flags = gather_column(frames, TE923Layout::PRESSURE + 1);
+    store_words(block.pressure, _mm_unpacklo_epi8(digits, flags), _mm_unpackhi_epi8(digits, flags));
+    store_flags(block.pressure_ok, _mm_andnot_si128(bit_set(flags, (char)0xF0), _mm_set1_epi8(-1)));
+
+    /* Wind chill */
+    digits = gather_column(frames, TE923Layout::WIND_CHILL);
+    flags = gather_column(frames, TE923Layout::WIND_CHILL + 1);
+    unpack_temperature(block.wind_chill, digits, flags, _mm_and_si128(bcd_valid(digits), bit_set(flags, 0x40)));
+
+    /* Wind gust and speed */
+    gust = gather_column(frames, TE923Layout::WIND_GUST);
+    gust_flags = gather_column(frames, TE923Layout::WIND_GUST + 1);
+    gust_ok = bcd_valid(gust);
+    unpack_wind(block.wind_gust, gust, gust_flags, gust_ok);
+
+    speed = gather_column(frames, TE923Layout::WIND_SPEED);
+    speed_flags = gather_column(frames, TE923Layout::WIND_SPEED + 1);
+    speed_ok = bcd_valid(speed);
+    unpack_wind(block.wind_speed, speed, speed_flags, speed_ok);
+
+    /* Wind direction, unless the wind sensor is out of range */
+    digits = gather_column(frames, TE923Layout::WIND_DIR);
+    store_bytes(block.wind_dir, low_nibble(digits));
+    store_flags(block.wind_dir_ok, _mm_and_si128(
+        _mm_or_si128(gust_ok, _mm_and_si128(equals(gust, (char)0xBB), equals(gust_flags, (char)0x8B))),
+        _mm_or_si128(speed_ok, _mm_and_si128(equals(speed, (char)0xBB), equals(speed_flags, (char)0x8B)))));
+
+    /* UV index, unpacked as a positive temperature without the 0.05 flag */
+    digits = gather_column(frames, TE923Layout::UV);
+    flags = low_nibble(gather_column(frames, TE923Layout::UV + 1));
+    unpack_temperature(block.uv, digits, _mm_or_si128(flags, _mm_set1_epi8((char)0x80)), _mm_and_si128(bcd_valid(digits), digit_valid(flags)));
+
+    /* Rain counter */
+    digits = gather_column(frames, TE923Layout::RAIN);
+    flags = gather_column(frames, TE923Layout::RAIN + 1);
+    store_words(block.rain, _mm_unpacklo_epi8(digits, flags), _mm_unpackhi_epi8(digits, flags));
+}
+
+#if defined(__AVX2__)
+
+/// Vector of doubles used to convert the values.
+typedef __m256d vdouble;
+/// Number of values converted together.
+const int VD_LANES = 4;
+
+static inline vdouble vd_load(const int32_t* src) { return _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)src)); }
+static inline vdouble vd_set(double value) { return _mm256_set1_pd(value); }
+static inline vdouble vd_add(vdouble a, vdouble b) { return _mm256_add_pd(a, b); }
+static inline vdouble vd_mul(vdouble a, vdouble b) { return _mm256_mul_pd(a, b); }
+static inline vdouble vd_div(vdouble a, vdouble b) { return _mm256_div_pd(a, b); }
+static inline vdouble vd_and(vdouble a, vdouble b) { return _mm256_and_pd(a, b); }
+static inline vdouble vd_xor(vdouble a, vdouble b) { return _mm256_xor_pd(a, b); }
+static inline vdouble vd_select(vdouble mask, vdouble a, vdouble b) { return _mm256_blendv_pd(b, a, mask); }
+static inline vdouble vd_mask(const int32_t* src) { return _mm256_cmp_pd(vd_load(src), vd_set(1.0), _CMP_EQ_OQ); }
+static inline vdouble vd_to_float(vdouble a) { return _mm256_cvtps_pd(_mm256_cvtpd_ps(a)); }
+static inline void vd_store(float* dst, vdouble a) { _mm_storeu_ps(dst, _mm256_cvtpd_ps(a)); }
+
+#else
+
+/// Vector of doubles used to convert the values.
+typedef __m128d vdouble;
+/// Number of values converted together.
+const int VD_LANES = 2;
+
+static inline vdouble vd_load(const int32_t* src) { return _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)src)); }
+static inline vdouble vd_set(double value) { return _mm_set1_pd(value); }
+static inline vdouble vd_add(vdouble a, vdouble b) { return _mm_add_pd(a, b); }
+static inline vdouble vd_mul(vdouble a, vdouble b) { return _mm_mul_pd(a, b); }
+static inline vdouble vd_div(vdouble a, vdouble b) { return _mm_div_pd(a, b); }
+static inline vdouble vd_and(vdouble a, vdouble b) { return _mm_and_pd(a, b); }
+static inline vdouble vd_xor(vdouble a, vdouble b) { return _mm_xor_pd(a, b); }
+static inline vdouble vd_select(vdouble mask, vdouble a, vdouble b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+static inline vdouble vd_mask(const int32_t* src) { return _mm_cmpeq_pd(vd_load(src), vd_set(1.0)); }
+static inline vdouble vd_to_float(vdouble a) { return _mm_cvtps_pd(_mm_cvtpd_ps(a)); }
+static inline void vd_store(float* dst, vdouble a) { _mm_storel_pi((__m64*)dst, _mm_cvtpd_ps(a)); }
+
+#endif
+
+/**
+ * @brief Convert a temperature field of a block
+ *
+ * Follows the operations of decode_frame(): the value is calculated in
+ * double precision and rounded to float before and after adding 0.05.
+ *
+ * @param columns Unpacked field
+ * @param dst Column where the values are stored
+ */
+static inline void convert_temperature(const TemperatureColumns& columns, float* dst)
+{
+    vdouble value, half;
+
+    for (int f = 0; f < BATCH_BLOCK; f += VD_LANES) {
+        value = vd_to_float(vd_add(vd_div(vd_load(columns.value + f), vd_set(10.0)), vd_mul(vd_load(columns.tens + f), vd_set(10.0))));
+        half = vd_to_float(vd_add(value, vd_set(0.05)));
+        value = vd_select(vd_mask(columns.half + f), half, value);
+        value = vd_xor(value, vd_and(vd_mask(columns.negative + f), vd_set(-0.0)));
+        vd_store(dst + f, vd_and(vd_mask(columns.ok + f), value));
+    }
+}
+
+/**
+ * @brief Convert a wind field of a block, from mph to kmh
+ *
+ * @param columns Unpacked field
+ * @param dst Column where the values are stored
+ */
+static inline void convert_wind(const WindColumns& columns, float* dst)
+{
+    vdouble value;
+
+    for (int f = 0; f < BATCH_BLOCK; f += VD_LANES) {
+        value = vd_add(vd_div(vd_load(columns.value + f), vd_set(10.0)), vd_mul(vd_load(columns.tens + f), vd_set(10.0)));
+        value = vd_to_float(vd_div(vd_add(value, vd_load(columns.offset + f)), vd_set(2.23694)));
+        value = vd_mul(value, vd_set(3.6));
+        vd_store(dst + f, vd_and(vd_mask(columns.ok + f), value));
+    }
+}
+
+/**
+ * @brief Convert the unpacked fields of a block into the columns
+ *
+ * The statuses of the frames with some value not available are taken from
+ * decode_frame_status(), which also counts them in the diagnostics.
+ *
+ * @param frames Frames of the batch
+ * @param block Unpacked fields
+ * @param start Position of the first frame of the block in the columns
+ * @param columns Columns where the values are stored
+ */
+static void convert_block(const RawFrame* frames, const BlockColumns& block, size_t start, const DecodedColumns& columns)
+{
+    uint32_t valid;
+
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        convert_temperature(block.temperature[i], columns.temperature[i] + start);
+        for (int f = 0; f < BATCH_BLOCK; f++)
+            columns.humidity[i][start + f] = block.humidity_ok[i][f] ? (float)block.humidity[i][f] : 0.0f;
+    }
+    convert_temperature(block.wind_chill, columns.wind_chill + start);
+    convert_wind(block.wind_gust, columns.wind_gust + start);
+    convert_wind(block.wind_speed, columns.wind_speed + start);
+    convert_temperature(block.uv, columns.uv + start);
+
+    for (int f = 0; f < BATCH_BLOCK; f++) {
+        columns.pressure[start + f] = block.pressure_ok[f] ? (float)(block.pressure[f] * 0.0625) : 0.0f;
+        columns.wind_dir[start + f] = block.wind_dir_ok[f] ? (float)(block.wind_dir[f] * 22.5) : 0.0f;
+        columns.rain[start + f] = (float)(block.rain[f] * TE923Layout::RAIN_MM_PER_TIP);
+
+        valid = 0;
+        for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+            valid |= block.temperature[i].ok[f] ? DECODED_TEMPERATURE << i : 0;
+            valid |= block.humidity_ok[i][f] ? DECODED_HUMIDITY << i : 0;
+        }
+        valid |= block.pressure_ok[f] ? DECODED_PRESSURE : 0;
+        valid |= block.wind_chill.ok[f] ? DECODED_WIND_CHILL : 0;
+        valid |= block.wind_gust.ok[f] ? DECODED_WIND_GUST : 0;
+        valid |= block.wind_speed.ok[f] ? DECODED_WIND_SPEED : 0;
+        valid |= block.wind_dir_ok[f] ? DECODED_WIND_DIR : 0;
+        valid |= block.uv.ok[f] ? DECODED_UV : 0;
+        valid |= DECODED_RAIN;
+        columns.valid[start + f] = valid;
+        columns.status[start + f] = valid == DECODED_ALL ? 0 : decode_frame_status(frames[start + f]);
+    }
+}
+
+#endif
+
+/**
+ * @brief Function to decode a batch of frames into columns
+ *
+ * Gives the same values as decode_frame() for each frame, using the SIMD
+ * instructions available in the build.
+ *
+ * @param frames Frames of the batch, laid out contiguously
+ * @param count Number of frames
+ * @param columns Columns where the values are stored
+ */
+void decode_frames (const RawFrame* frames, size_t count, const DecodedColumns& columns)
+{
+    size_t done = 0;
+
+    #if defined(__SSE2__)
+    BlockColumns block;
+
+    for (; done + BATCH_BLOCK <= count; done += BATCH_BLOCK) {
+        unpack_block(frames + done, block);
+        convert_block(frames, block, done, columns);
+    }
+    #endif
+
+    decode_range(frames, done, count, columns);
+}
+
+/**
+ * @brief Function to decode a batch of frames into columns, frame by frame
+ *
+ * Reference version of decode_frames(), without SIMD instructions.
+ *
+ * @param frames Frames of the batch, laid out contiguously
+ * @param count Number of frames
+ * @param columns Columns where the values are stored
+ */
+void decode_frames_scalar (const RawFrame* frames, size_t count, const DecodedColumns& columns)
+{
+    decode_range(frames, 0, count, columns);
+}
+
+/**
+ * @brief Get the instruction set used by decode_frames()
+ *
+ * @return const char* "avx2", "sse2" or "scalar"
+ */
+const char* decode_frames_isa ()
+{
+    #if defined(__AVX2__)
+    return "avx2";
+    #elif defined(__SSE2__)
+    return "sse2";
+    #else
+    return "scalar";
+    #endif
+}
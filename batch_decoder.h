@@ -0,0 +1,58 @@
+/**
+ * @file batch_decoder.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Library to decode many frames at once
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Batch version of decode_frame(), for the replays, the history recoveries
+ * and any other place where thousands of frames are decoded together. The
+ * values are written in columns, one array per field.
+ */
+
+#ifndef BATCH_DECODER_H
+#define BATCH_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "data_decoder.h"
+
+/**
+ * @brief Columns where a batch of frames is decoded
+ *
+ * Each pointer is an array supplied by the caller, with room for a value of
+ * each frame of the batch. The values are the same decode_frame() gives.
+ */
+struct DecodedColumns {
+    /// Temperatures of each channel, in ºC.
+    float *temperature[TE923_FRAME_SENSORS];
+    /// Humidities of each channel, in %.
+    float *humidity[TE923_FRAME_SENSORS];
+    /// Pressures in mb.
+    float *pressure;
+    /// Wind chills in ºC.
+    float *wind_chill;
+    /// Wind gusts in kmh.
+    float *wind_gust;
+    /// Wind speeds in kmh.
+    float *wind_speed;
+    /// Wind directions in degrees.
+    float *wind_dir;
+    /// UV indexes.
+    float *uv;
+    /// Rain since the station was reset, in mm.
+    float *rain;
+    /// DECODED_* flags of the values available.
+    uint32_t *valid;
+    /// FieldStatus of the values, as DecodedFrame::status.
+    uint64_t *status;
+};
+
+void decode_frames (const RawFrame* frames, size_t count, const DecodedColumns& columns);
+void decode_frames_scalar (const RawFrame* frames, size_t count, const DecodedColumns& columns);
+const char* decode_frames_isa ();
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file bcd_table.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Lookup tables to decode the BCD bytes of the frames
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Tables generated at compile time with the value of every byte read as two
+ * BCD digits and the validity of each digit, so the decoders replace the
+ * arithmetic and the range checks of each byte by a single lookup.
+ */
+
+#ifndef BCD_TABLE_H
+#define BCD_TABLE_H
+
+#include <cstdint>
+
+/// Flag of a byte whose low nibble is a valid BCD digit.
+const uint8_t BCD_LOW_VALID = 0x01;
+/// Flag of a byte whose high nibble is a valid BCD digit.
+const uint8_t BCD_HIGH_VALID = 0x02;
+/// Flags of a byte whose two nibbles are valid BCD digits.
+const uint8_t BCD_VALID = BCD_LOW_VALID | BCD_HIGH_VALID;
+
+/**
+ * @brief Value and validity of every byte read as two BCD digits
+ */
+struct BcdTable {
+    /// High nibble * 10 + low nibble, as bcd2int() (even for invalid digits).
+    uint8_t value[256];
+    /// BCD_*_VALID flags of the nibbles.
+    uint8_t flags[256];
+};
+
+/// List of indexes, to expand the table entries at compile time.
+template<int... I> struct BcdIndexes {};
+
+/// Builds BcdIndexes<0, ..., N-1>.
+template<int N, int... I> struct MakeBcdIndexes : MakeBcdIndexes<N - 1, N - 1, I...> {};
+template<int... I> struct MakeBcdIndexes<0, I...> { typedef BcdIndexes<I...> type; };
+
+/**
+ * @brief Value of a byte read as two BCD digits
+ *
+ * @param byte Byte to decode
+ * @return uint8_t High nibble * 10 + low nibble
+ */
+constexpr uint8_t bcd_value(int byte) {
+    return (uint8_t)((byte >> 4) * 10 + (byte & 0x0F));
+}
+
+/**
+ * @brief Validity of the nibbles of a byte read as two BCD digits
+ *
+ * @param byte Byte to check
+ * @return uint8_t BCD_*_VALID flags of the byte
+ */
+constexpr uint8_t bcd_flags(int byte) {
+    return (uint8_t)(((byte & 0x0F) <= 9 ? BCD_LOW_VALID : 0) | ((byte >> 4) <= 9 ? BCD_HIGH_VALID : 0));
+}
+
+/**
+ * @brief Build the table with the entries of the indexes
+ *
+ * @return BcdTable Table with an entry for each index
+ */
+template<int... I>
+constexpr BcdTable make_bcd_table(BcdIndexes<I...>) {
+    return BcdTable{ { bcd_value(I)... }, { bcd_flags(I)... } };
+}
+
+/// Value and validity of every byte.
+constexpr BcdTable BCD_TABLE = make_bcd_table(MakeBcdIndexes<256>::type());
+
+#endif
@@ -0,0 +1,573 @@
+/**
+ * @file bench.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Microbenchmarks of the decoders and the processing of the frames
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Times each decode_* function, bcd2int(), the batch decoder, the dew point
+ * and RealFeel© calculations (per Observation and in an ObservationBatch),
+ * the PackedObservation records, their SpscRing queue between two threads
+ * and the line protocol formatting over a corpus of frame logs, and prints
+ * the nanoseconds per frame, the allocations per frame and the throughput
+ * of each one as JSON, so the results of different builds and hosts can be
+ * compared. Built with "make bench" (add SIMD=-mavx2 to use AVX2 in the
+ * batch decoder).
+ *
+ * Usage: WS3_bench [--rounds <n>] [--frames <n>] [corpus files...]
+ *        WS3_bench --write-corpus <dir>
+ *
+ * Without files, the corpus checked in under corpus/ is used. Any capture of
+ * a real station (see --capture) can be added to it. --write-corpus
+ * regenerates the synthetic files of the corpus.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+
+#include "batch_decoder.h"
+#include "data_decoder.h"
+#include "derived_values.h"
+#include "FrameLog.h"
+#include "line_protocol.h"
+#include "Observation.h"
+#include "ObservationBatch.h"
+#include "PackedObservation.h"
+#include "SimulatedFrameSource.h"
+#include "SpscRing.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+/// Seed of the synthetic frames, so the corpus can be regenerated.
+const unsigned int BENCH_SEED = 923;
+/// Frames of each synthetic file of the corpus.
+const int BENCH_CORPUS_FRAMES = 1000;
+/// Timestamp of the first frame of the synthetic files (2020-01-01).
+const int64_t BENCH_CORPUS_EPOCH_US = 1577836800000000LL;
+/// Minimum frames decoded in each round, repeating the corpus.
+const size_t BENCH_MIN_FRAMES = 100000;
+/// Files of the corpus checked in.
+const char* const BENCH_CORPUS[] = {
+    "corpus/simulated.frames",
+    "corpus/simulated_errors.frames",
+    "corpus/edge_cases.frames"
+};
+
+/**
+ * @brief Error pattern of the edge cases of the corpus
+ *
+ * The two bytes are written at the position of a clean frame.
+ */
+struct EdgeCase {
+    /// Position of the first byte.
+    int pos;
+    /// First byte.
+    uint8_t first;
+    /// Second byte.
+    uint8_t second;
+};
+
+/// Patterns of the edge cases: sensor errors, signs, flags and invalid digits.
+const EdgeCase BENCH_EDGE_CASES[] = {
+    {3, 0xAA, 0x0A},    // Sensor 1 without link
+    {6, 0xBB, 0x0B},    // Sensor 2 lost
+    {3, 0x5C, 0xC1},    // Sensor 1 lost (low nibble 0xC)
+    {6, 0x25, 0x82},    // Sensor 2 reading not ready (bit 6 clear)
+    {0, 0x45, 0x02},    // Negative temperature
+    {0, 0x45, 0x22},    // Negative temperature with 0.05
+    {0, 0x3F, 0xC1},    // Invalid digit
+    {20, 0xFF, 0xFF},   // Pressure not available
+    {23, 0xAA, 0x8A},   // Wind chill without link
+    {23, 0x12, 0x81},   // Wind chill not ready (bit 6 clear)
+    {25, 0xBB, 0x8B},   // Wind gust lost (direction kept)
+    {25, 0xEE, 0x8E},   // Wind gust out of range
+    {27, 0xAA, 0x8A},   // Wind speed without link
+    {27, 0x55, 0x12},   // Wind speed over 100 mph
+    {18, 0xAA, 0x0A},   // UV sensor without link
+    {18, 0x7B, 0x00}    // UV sensor lost
+};
+
+/// Allocations done through operator new.
+static atomic<unsigned long> allocations(0);
+
+/// Sum of the results, so the benchmarks are not optimized away.
+static volatile float bench_sink;
+
+/**
+ * @brief Allocate memory, counting the allocation
+ *
+ * Replaces the global operator new of the benchmark. The array and the
+ * nothrow versions call it, and every operator delete is replaced to match,
+ * so the memory is always given back with free().
+ */
+void* operator new(size_t size)
+{
+    void *ptr;
+
+    allocations.fetch_add(1, memory_order_relaxed);
+    ptr = malloc(size ? size : 1);
+    if (ptr == NULL)
+        throw bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/**
+ * @brief Write a list of frames as a frame log
+ *
+ * The file is replaced, and the frames are stamped one minute apart.
+ *
+ * @param path Path of the log
+ * @param frames Frames to write
+ * @return short int Result of the execution of the function.
+ */
+static short int write_frames(const string& path, const vector<FrameLogRecord>& frames)
+{
+    FrameLog log;
+    FrameLogRecord record;
+
+    remove(path.c_str());
+    if (log.openWrite(path) < 0)
+        return -1;
+
+    for (size_t f = 0; f < frames.size(); f++) {
+        record = frames[f];
+        record.timestamp_us = BENCH_CORPUS_EPOCH_US + (int64_t)f * 60000000;
+        record.crc_ok = check_crc(record.frame);
+        if (log.append(record) < 0)
+            return -2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Generate frames of the simulated station
+ *
+ * @param seed Seed of the station
+ * @param errors Error patterns injected
+ * @param count Number of frames
+ * @return vector<FrameLogRecord> Frames generated
+ */
+static vector<FrameLogRecord> simulate_frames(unsigned int seed, const SimulationErrors& errors, int count)
+{
+    SimulatedFrameSource source(0, count, seed);
+    vector<FrameLogRecord> frames(count);
+    unsigned int timestamp;
+
+    source.setErrors(errors);
+    for (int f = 0; f < count; f++)
+        source.readFrame(frames[f].frame, timestamp);
+
+    return frames;
+}
+
+/**
+ * @brief Regenerate the synthetic files of the corpus
+ *
+ * Writes simulated.frames (clean frames), simulated_errors.frames (frames
+ * with the error patterns of the simulated station) and edge_cases.frames
+ * (clean frames with each pattern of BENCH_EDGE_CASES and a valid CRC).
+ *
+ * @param dir Directory of the corpus
+ * @return short int Result of the execution of the function.
+ */
+static short int write_corpus(const string& dir)
+{
+    const int edge_cases = sizeof(BENCH_EDGE_CASES) / sizeof(BENCH_EDGE_CASES[0]);
+    vector<FrameLogRecord> clean, errors, edges;
+
+    clean = simulate_frames(BENCH_SEED, SimulationErrors{0, 0, 0, 0}, BENCH_CORPUS_FRAMES);
+    errors = simulate_frames(BENCH_SEED + 1, SimulationErrors{0.02, 0.05, 0.05, 0.05}, BENCH_CORPUS_FRAMES);
+
+    edges.resize((BENCH_CORPUS_FRAMES / edge_cases) * edge_cases);
+    for (size_t f = 0; f < edges.size(); f++) {
+        const EdgeCase &edge = BENCH_EDGE_CASES[f % edge_cases];
+
+        edges[f] = clean[f / edge_cases];
+        edges[f].frame[edge.pos] = edge.first;
+        edges[f].frame[edge.pos + 1] = edge.second;
+        edges[f].frame[33] = 0x00;
+        for (int i = 0; i <= 32; i++)
+            edges[f].frame[33] ^= edges[f].frame[i];
+    }
+
+    if (write_frames(dir + "/simulated.frames", clean) < 0 ||
+        write_frames(dir + "/simulated_errors.frames", errors) < 0 ||
+        write_frames(dir + "/edge_cases.frames", edges) < 0)
+        return -1;
+
+    return 0;
+}
+
+/**
+ * @brief Load the frames of the corpus
+ *
+ * @param paths Frame logs of the corpus
+ * @param frames Frames read
+ * @return short int Result of the execution of the function.
+ */
+static short int load_corpus(const vector<string>& paths, vector<FrameLogRecord>& frames)
+{
+    FrameLog log;
+    FrameLogRecord record;
+    short int retValue;
+
+    for (const string& path : paths) {
+        if (log.openRead(path) < 0)
+            return -1;
+        while ((retValue = log.next(record)) == 0)
+            frames.push_back(record);
+        if (retValue < 0)
+            return -2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Time a benchmark
+ *
+ * The benchmark is run the given rounds, keeping the fastest one, and the
+ * allocations of the last round are counted.
+ *
+ * @param name Name of the benchmark
+ * @param rounds Times the benchmark is run
+ * @param count Number of frames processed in each run
+ * @param bench Function processing the frames once
+ * @return json Result of the benchmark
+ */
+template<typename Bench>
+static json run_bench(const char* name, int rounds, size_t count, Bench bench)
+{
+    chrono::steady_clock::time_point start;
+    double best = 0, seconds;
+    unsigned long allocated = 0;
+
+    for (int r = 0; r < rounds; r++) {
+        allocated = allocations.load(memory_order_relaxed);
+        start = chrono::steady_clock::now();
+        bench();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        allocated = allocations.load(memory_order_relaxed) - allocated;
+        if (r == 0 || seconds < best)
+            best = seconds;
+    }
+
+    return json{
+        {"name", name},
+        {"ns_per_frame", best * 1e9 / count},
+        {"frames_per_s", count / best},
+        {"allocs_per_frame", (double)allocated / count}
+    };
+}
+
+int main(int argc, char** argv)
+{
+    int rounds = 10;
+    size_t min_frames = BENCH_MIN_FRAMES;
+    vector<string> paths;
+    vector<FrameLogRecord> corpus;
+    vector<Observation> observations;
+    vector<PackedObservation> packed;
+    SpscRing<PackedObservation, 256> ring;
+    ObservationBatch batch;
+    vector<float> values[2 * TE923_FRAME_SENSORS + 7];
+    vector<uint32_t> valid;
+    vector<uint64_t> status;
+    DecodedColumns columns;
+    DecodedFrame decoded;
+    ostringstream line;
+    json results = json::array();
+    size_t count;
+    int v = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            min_frames = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--write-corpus") == 0 && i + 1 < argc) {
+            return write_corpus(argv[++i]) < 0 ? 1 : 0;
+        } else if (argv[i][0] == '-') {
+            cerr << "Usage: " << argv[0] << " [--rounds <n>] [--frames <n>] [corpus files...]" << endl;
+            cerr << "       " << argv[0] << " --write-corpus <dir>" << endl;
+            return 1;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty())
+        paths.assign(BENCH_CORPUS, BENCH_CORPUS + sizeof(BENCH_CORPUS) / sizeof(BENCH_CORPUS[0]));
+
+    if (load_corpus(paths, corpus) < 0 || corpus.empty() || rounds <= 0) {
+        cerr << "No frames to benchmark" << endl;
+        return 1;
+    }
+
+    /* Repeat the corpus up to the minimum frames of a round */
+    count = ((min_frames + corpus.size() - 1) / corpus.size()) * corpus.size();
+    if (count == 0)
+        count = corpus.size();
+    vector<RawFrame> frames(count);
+    observations.resize(count);
+    for (size_t f = 0; f < count; f++) {
+        memcpy(frames[f], corpus[f % corpus.size()].frame, BUFLEN);
+
+        decoded = decode_frame(frames[f]);
+        observations[f].setStationId("bench");
+        observations[f].setTimestamp(corpus[f % corpus.size()].timestamp_us / 1000000);
+        observations[f].setPressure(decoded.pressure);
+        for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+            observations[f].setTemperature(decoded.temperature[i], i);
+            observations[f].setHumidity(decoded.humidity[i], i);
+        }
+        observations[f].setWindChill(decoded.wind_chill);
+        observations[f].setWindGust(decoded.wind_gust);
+        observations[f].setWindSpeed(decoded.wind_speed);
+        observations[f].setWindDir(decoded.wind_dir);
+        observations[f].setUVIndex(decoded.uv);
+        observations[f].setRainfall(decoded.rain);
+    }
+
+    packed.resize(count);
+    batch.reserve(count);
+    for (size_t f = 0; f < count; f++)
+        batch.push_back(observations[f]);
+    for (auto& column : values)
+        column.resize(count);
+    valid.resize(count);
+    status.resize(count);
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        columns.temperature[i] = values[v++].data();
+        columns.humidity[i] = values[v++].data();
+    }
+    columns.pressure = values[v++].data();
+    columns.wind_chill = values[v++].data();
+    columns.wind_gust = values[v++].data();
+    columns.wind_speed = values[v++].data();
+    columns.wind_dir = values[v++].data();
+    columns.uv = values[v++].data();
+    columns.rain = values[v++].data();
+    columns.valid = valid.data();
+    columns.status = status.data();
+
+    /* Per-field decoders */
+    results.push_back(run_bench("decode_temperature (list)", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_temperature(frames[f]).front();
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_temperature", rounds, count, [&]() {
+        array<float, TE923_FRAME_SENSORS> temps;
+        float sum = 0;
+        for (size_t f = 0; f < count; f++) {
+            decode_temperature(frames[f], temps);
+            sum += temps[0];
+        }
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_humidity (list)", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_humidity(frames[f]).front();
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_humidity", rounds, count, [&]() {
+        array<float, TE923_FRAME_SENSORS> hums;
+        float sum = 0;
+        for (size_t f = 0; f < count; f++) {
+            decode_humidity(frames[f], hums);
+            sum += hums[0];
+        }
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_pressure", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_pressure(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_wind_chill", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_wind_chill(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_wind_gust", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_wind_gust(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_wind_speed", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_wind_speed(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_wind_dir", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_wind_dir(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_uv", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_uv(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_rain", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += decode_rain(frames[f]);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("bcd2int", rounds, count, [&]() {
+        int sum = 0;
+        for (size_t f = 0; f < count; f++)
+            for (int i = 0; i < BUFLEN; i++)
+                sum += bcd2int((char)frames[f][i]);
+        bench_sink = sum;
+    }));
+
+    /* Whole frame decoders */
+    results.push_back(run_bench("decode_frame", rounds, count, [&]() {
+        DecodedFrame decoded;
+        float sum = 0;
+        for (size_t f = 0; f < count; f++) {
+            decoded = decode_frame(frames[f]);
+            sum += decoded.temperature[0] + decoded.wind_speed;
+        }
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("decode_frames_scalar", rounds, count, [&]() {
+        decode_frames_scalar(frames.data(), count, columns);
+    }));
+    results.push_back(run_bench("decode_frames", rounds, count, [&]() {
+        decode_frames(frames.data(), count, columns);
+    }));
+
+    /* Derived values and output */
+    results.push_back(run_bench("calculateDewPoint", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++) {
+            observations[f].calculateDewPoint();
+            sum += observations[f].getDewPoint();
+        }
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("calculate_dew_point (not integer)", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++)
+            sum += calculate_dew_point(observations[f].getTemperature(1), observations[f].getHumidity(1) + 0.5f);
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("calculateRealFeel", rounds, count, [&]() {
+        float sum = 0;
+        for (size_t f = 0; f < count; f++) {
+            observations[f].calculateRealFeel(3);
+            sum += observations[f].getRealFeel();
+        }
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("ObservationBatch::calculateDewPoint", rounds, count, [&]() {
+        batch.calculateDewPoint();
+        bench_sink = batch.getDewPoints()[count - 1];
+    }));
+    results.push_back(run_bench("ObservationBatch::calculateRealFeel", rounds, count, [&]() {
+        batch.calculateRealFeel();
+        bench_sink = batch.getRealFeels()[count - 1];
+    }));
+    results.push_back(run_bench("PackedObservation::pack", rounds, count, [&]() {
+        for (size_t f = 0; f < count; f++)
+            packed[f].pack(observations[f]);
+        bench_sink = packed[count - 1].temperature[0];
+    }));
+    results.push_back(run_bench("PackedObservation::unpack", rounds, count, [&]() {
+        Observation obs;
+        float sum = 0;
+        for (size_t f = 0; f < count; f++) {
+            packed[f].unpack(obs);
+            sum += obs.getTemperature(0);
+        }
+        bench_sink = sum;
+    }));
+    results.push_back(run_bench("SpscRing<PackedObservation> (2 threads)", rounds, count, [&]() {
+        thread consumer([&]() {
+            PackedObservation record;
+            float sum = 0;
+            for (size_t f = 0; f < count; f++) {
+                while (!ring.pop(record))
+                    this_thread::yield();
+                sum += record.temperature[0];
+            }
+            bench_sink = sum;
+        });
+        for (size_t f = 0; f < count; f++) {
+            while (!ring.push(packed[f]))
+                this_thread::yield();
+        }
+        consumer.join();
+    }));
+    results.push_back(run_bench("format_line_protocol", rounds, count, [&]() {
+        for (size_t f = 0; f < count; f++) {
+            line.seekp(0);
+            format_line_protocol(line, observations[f]);
+        }
+        bench_sink = line.tellp();
+    }));
+
+    cout << json{
+        {"isa", decode_frames_isa()},
+        {"corpus", {{"files", paths}, {"frames", corpus.size()}}},
+        {"frames_per_round", count},
+        {"rounds", rounds},
+        {"results", results}
+    }.dump(2) << endl;
+
+    return 0;
+}
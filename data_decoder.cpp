@@ -14,11 +14,445 @@
 #include "data_decoder.h"
 
 #include <cstring>
-#include <iostream>
 #include <list>
 
+#include "bcd_table.h"
+#include "logger.h"
+
 using namespace std;
 
+/**
+ * @brief Check the BCD table against the arithmetic of bcd2int()
+ * 
+ * @param byte First byte to check
+ * @return true Every entry from the byte matches the arithmetic
+ * @return false Some entry does not match
+ */
+constexpr bool bcd_table_matches(int byte)
+{
+    return byte == 256 || (
+        BCD_TABLE.value[byte] == ((int)(((char)byte & 0xF0) >> 4) * 10 + (int)((char)byte & 0x0F)) &&
+        ((BCD_TABLE.flags[byte] & BCD_LOW_VALID) != 0) == ((byte & 0x0F) <= 9) &&
+        ((BCD_TABLE.flags[byte] & BCD_HIGH_VALID) != 0) == ((int)(((char)(byte & 0xF0) & 0xF0) >> 4) * 10 <= 90) &&
+        bcd_table_matches(byte + 1));
+}
+
+static_assert(bcd_table_matches(0), "The BCD table does not match bcd2int()");
+
+/**
+ * @brief Check if both nibbles of a byte are valid BCD digits
+ * 
+ * @param byte Byte to check
+ * @return true The byte is a valid BCD number
+ * @return false Some nibble is greater than 9
+ */
+static inline bool bcd_valid(uint8_t byte)
+{
+    return (BCD_TABLE.flags[byte] & BCD_VALID) == BCD_VALID;
+}
+
+/**
+ * @brief Check if the low nibble of a byte is a valid BCD digit
+ * 
+ * @param byte Byte to check
+ * @return true The low nibble is a valid BCD digit
+ * @return false The low nibble is greater than 9
+ */
+static inline bool bcd_low_valid(uint8_t byte)
+{
+    return (BCD_TABLE.flags[byte] & BCD_LOW_VALID) != 0;
+}
+
+/// Counters of the values not available, shared by every decoder.
+static DecodeDiagnostics diagnostics;
+
+/// Name of each DecodedField.
+static const char* const FIELD_NAMES[FIELD_COUNT] = {
+    "temperature 0", "temperature 1", "temperature 2", "temperature 3", "temperature 4", "temperature 5",
+    "humidity 0", "humidity 1", "humidity 2", "humidity 3", "humidity 4", "humidity 5",
+    "pressure", "wind chill", "wind gust", "wind speed", "wind dir", "uv", "rain"
+};
+
+/// Name of each FieldStatus.
+static const char* const STATUS_NAMES[STATUS_COUNT] = {
+    "ok", "no link", "sensor lost", "out of range", "invalid"
+};
+
+/**
+ * @brief Count a value not available
+ * 
+ * @param field DecodedField of the value
+ * @param status Status of the value
+ */
+static inline void count_error(int field, FieldStatus status)
+{
+    diagnostics.errors[field][status].fetch_add(1, memory_order_relaxed);
+    LOG_DEBUG("Missing %s: %s", FIELD_NAMES[field], STATUS_NAMES[status]);
+}
+
+/**
+ * @brief Store the status of a value, counting it if it is not available
+ * 
+ * @param status Status mask of the frame
+ * @param valid Valid flags of the frame
+ * @param field DecodedField of the value
+ * @param value_status Status of the value
+ */
+static inline void set_status(uint64_t& status, uint32_t& valid, int field, FieldStatus value_status)
+{
+    if (value_status == STATUS_OK) {
+        valid |= 1 << field;
+    } else {
+        status |= (uint64_t)value_status << (field * FIELD_STATUS_BITS);
+        count_error(field, value_status);
+    }
+}
+
+/**
+ * @brief Status of the temperature of a sensor
+ * 
+ * The low nibble of the first byte is 0xA without link, and 0xB or 0xC when
+ * the sensor was lost. The remote sensors also clear the bit 6 of the second
+ * byte when the reading is not available.
+ * 
+ * @param digits Byte with the tenths and units of the temperature
+ * @param flags Byte with the flags and the tens of the temperature
+ * @param i Number of sensor
+ * @return FieldStatus Status of the temperature
+ */
+static inline FieldStatus temperature_status(uint8_t digits, uint8_t flags, int i)
+{
+    uint8_t low = digits & 0x0F;
+
+    if (low == 0x0A)
+        return STATUS_NO_LINK;
+    if (low == 0x0B || low == 0x0C)
+        return STATUS_SENSOR_LOST;
+    if (!bcd_low_valid(digits))
+        return STATUS_INVALID;
+    if (i > 0 && (flags & 0x40) != 0x40)
+        return STATUS_SENSOR_LOST;
+    return STATUS_OK;
+}
+
+/**
+ * @brief Status of the humidity of a sensor
+ * 
+ * The humidity is lost with the sensor, but not when only the temperature
+ * bytes are invalid.
+ * 
+ * @param digits Byte with the tenths and units of the temperature
+ * @param flags Byte with the flags and the tens of the temperature
+ * @param humidity Byte of the humidity
+ * @param i Number of sensor
+ * @param temperature Status of the temperature of the sensor
+ * @return FieldStatus Status of the humidity
+ */
+static inline FieldStatus humidity_status(uint8_t digits, uint8_t flags, uint8_t humidity, int i, FieldStatus temperature)
+{
+    uint8_t low = digits & 0x0F;
+
+    if (low == 0x0B || low == 0x0C || (i > 0 && (flags & 0x40) != 0x40))
+        return temperature == STATUS_NO_LINK ? STATUS_NO_LINK : STATUS_SENSOR_LOST;
+    if (!bcd_low_valid(humidity))
+        return STATUS_INVALID;
+    return STATUS_OK;
+}
+
+/**
+ * @brief Status of a value of the wind sensor
+ * 
+ * The station reports the errors with the patterns 0xAA 0x8A (no link),
+ * 0xBB 0x8B (lost) and 0xEE 0x8E (out of range).
+ * 
+ * @param digits Byte with the tenths and units
+ * @param flags Byte with the flags and the tens
+ * @return FieldStatus Status of the value
+ */
+static inline FieldStatus wind_status(uint8_t digits, uint8_t flags)
+{
+    if (bcd_valid(digits))
+        return STATUS_OK;
+    if (digits == 0xAA && flags == 0x8A)
+        return STATUS_NO_LINK;
+    if (digits == 0xBB && flags == 0x8B)
+        return STATUS_SENSOR_LOST;
+    if (digits == 0xEE && flags == 0x8E)
+        return STATUS_OUT_OF_RANGE;
+    return STATUS_INVALID;
+}
+
+/**
+ * @brief Status of the wind chill
+ * 
+ * @param digits Byte with the tenths and units
+ * @param flags Byte with the flags and the tens
+ * @return FieldStatus Status of the wind chill
+ */
+static inline FieldStatus wind_chill_status(uint8_t digits, uint8_t flags)
+{
+    FieldStatus status = wind_status(digits, flags);
+
+    if (status == STATUS_OK && (flags & 0x40) != 0x40)
+        return STATUS_SENSOR_LOST;
+    return status;
+}
+
+/**
+ * @brief Status of the UV index
+ * 
+ * As in the temperatures, the low nibble of the first byte is 0xA without
+ * link with the UV sensor, and 0xB or 0xC when it was lost.
+ * 
+ * @param digits Byte with the tenths and units
+ * @param tens Byte with the tens
+ * @return FieldStatus Status of the UV index
+ */
+static inline FieldStatus uv_status(uint8_t digits, uint8_t tens)
+{
+    uint8_t low = digits & 0x0F;
+
+    if (low == 0x0A)
+        return STATUS_NO_LINK;
+    if (low == 0x0B || low == 0x0C)
+        return STATUS_SENSOR_LOST;
+    if (!bcd_valid(digits) || !bcd_low_valid(tens))
+        return STATUS_INVALID;
+    return STATUS_OK;
+}
+
+/**
+ * @brief Value of a temperature field (also used for the wind chill)
+ * 
+ * @param digits Byte with the tenths and units
+ * @param flags Byte with the flags and the tens
+ * @return float Temperature in ºC
+ */
+static inline float temperature_value(uint8_t digits, uint8_t flags)
+{
+    float value = (BCD_TABLE.value[digits] / 10.0) + ((flags & 0x0F) * 10.0);
+
+    if ((flags & 0x20) == 0x20)
+        value += 0.05;
+    if ((flags & 0x80) != 0x80)
+        value *= -1;
+    return value;
+}
+
+/**
+ * @brief Value of a wind gust or speed field
+ * 
+ * @param digits Byte with the tenths and units
+ * @param flags Byte with the flags and the tens
+ * @return float Wind speed in kmh
+ */
+static inline float wind_value(uint8_t digits, uint8_t flags)
+{
+    float value = ((BCD_TABLE.value[digits] / 10.0) + ((flags & 0x0F) * 10.0) + ((flags & 0x10) == 0x10 ? 100 : 0)) / 2.23694;
+
+    return value * 3.6;
+}
+
+/**
+ * @brief Check at compile time that a layout fits in a frame
+ * 
+ * @tparam Layout Layout of the frame (see frame_layout.h)
+ */
+template<typename Layout>
+static inline void check_layout ()
+{
+    static_assert(Layout::SENSORS <= TE923_FRAME_SENSORS, "The layout has more sensors than DecodedFrame");
+    static_assert(Layout::TEMPERATURE + (Layout::SENSORS - 1) * Layout::SENSOR_STRIDE + 1 < BUFLEN &&
+                  Layout::HUMIDITY + (Layout::SENSORS - 1) * Layout::SENSOR_STRIDE < BUFLEN &&
+                  Layout::UV + 1 < BUFLEN && Layout::PRESSURE + 1 < BUFLEN &&
+                  Layout::WIND_CHILL + 1 < BUFLEN && Layout::WIND_GUST + 1 < BUFLEN &&
+                  Layout::WIND_SPEED + 1 < BUFLEN && Layout::WIND_DIR < BUFLEN &&
+                  Layout::RAIN + 1 < BUFLEN, "The layout does not fit in a frame");
+}
+
+/**
+ * @brief Function to get the status of every value of a frame
+ * 
+ * Same statuses as decode_frame(), without converting the values. The
+ * values not available are counted in the diagnostics.
+ * 
+ * @tparam Layout Layout of the frame (see frame_layout.h)
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return uint64_t FieldStatus of each value, as DecodedFrame::status
+ */
+template<typename Layout>
+uint64_t decode_frame_status (const RawFrame& raw_data)
+{
+    check_layout<Layout>();
+
+    uint64_t status = 0;
+    uint32_t available = 0;
+    FieldStatus temperature;
+    FieldStatus gust;
+    FieldStatus speed;
+    uint8_t digits;
+    uint8_t flags;
+
+    /* Temperature and humidity of each channel */
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        if (i >= Layout::SENSORS) {
+            set_status(status, available, FIELD_TEMPERATURE + i, STATUS_NO_LINK);
+            set_status(status, available, FIELD_HUMIDITY + i, STATUS_NO_LINK);
+            continue;
+        }
+
+        digits = raw_data[Layout::TEMPERATURE + i * Layout::SENSOR_STRIDE];
+        flags = raw_data[Layout::TEMPERATURE + i * Layout::SENSOR_STRIDE + 1];
+        temperature = temperature_status(digits, flags, i);
+        set_status(status, available, FIELD_TEMPERATURE + i, temperature);
+        set_status(status, available, FIELD_HUMIDITY + i,
+                   humidity_status(digits, flags, raw_data[Layout::HUMIDITY + i * Layout::SENSOR_STRIDE], i, temperature));
+    }
+
+    set_status(status, available, FIELD_PRESSURE,
+               (raw_data[Layout::PRESSURE + 1] & 0xF0) == 0xF0 ? STATUS_INVALID : STATUS_OK);
+    set_status(status, available, FIELD_WIND_CHILL, wind_chill_status(raw_data[Layout::WIND_CHILL], raw_data[Layout::WIND_CHILL + 1]));
+
+    /* Wind direction, unless the wind sensor is out of range */
+    gust = wind_status(raw_data[Layout::WIND_GUST], raw_data[Layout::WIND_GUST + 1]);
+    speed = wind_status(raw_data[Layout::WIND_SPEED], raw_data[Layout::WIND_SPEED + 1]);
+    set_status(status, available, FIELD_WIND_GUST, gust);
+    set_status(status, available, FIELD_WIND_SPEED, speed);
+    set_status(status, available, FIELD_WIND_DIR, wind_dir_status(gust, speed));
+
+    set_status(status, available, FIELD_UV, uv_status(raw_data[Layout::UV], raw_data[Layout::UV + 1]));
+
+    /* The station keeps the rain counter when the rain sensor is lost */
+    set_status(status, available, FIELD_RAIN, STATUS_OK);
+
+    return status;
+}
+
+/**
+ * @brief Function to decode every value of a frame in a single pass
+ * 
+ * Gives the same values as the decode_* functions, but each byte is
+ * validated once and nothing is printed nor allocated. The values not
+ * available are counted in the diagnostics.
+ * 
+ * The positions of the fields are taken from the layout of the station
+ * model, so they are constants in the decoder of each model.
+ * 
+ * @tparam Layout Layout of the frame (see frame_layout.h)
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return DecodedFrame Values decoded, with their valid flags and statuses
+ */
+template<typename Layout>
+DecodedFrame decode_frame (const RawFrame& raw_data)
+{
+    check_layout<Layout>();
+
+    DecodedFrame decoded;
+    uint64_t status = 0;
+    uint32_t available = 0;
+    FieldStatus field_status;
+    FieldStatus gust;
+    FieldStatus speed;
+    uint8_t digits;
+    uint8_t flags;
+
+    /* Temperature and humidity of each channel */
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        decoded.temperature[i] = 0.0;
+        decoded.humidity[i] = 0.0;
+        if (i >= Layout::SENSORS) {
+            set_status(status, available, FIELD_TEMPERATURE + i, STATUS_NO_LINK);
+            set_status(status, available, FIELD_HUMIDITY + i, STATUS_NO_LINK);
+            continue;
+        }
+
+        digits = raw_data[Layout::TEMPERATURE + i * Layout::SENSOR_STRIDE];
+        flags = raw_data[Layout::TEMPERATURE + i * Layout::SENSOR_STRIDE + 1];
+
+        field_status = temperature_status(digits, flags, i);
+        set_status(status, available, FIELD_TEMPERATURE + i, field_status);
+        if (field_status == STATUS_OK)
+            decoded.temperature[i] = temperature_value(digits, flags);
+
+        field_status = humidity_status(digits, flags, raw_data[Layout::HUMIDITY + i * Layout::SENSOR_STRIDE], i, field_status);
+        set_status(status, available, FIELD_HUMIDITY + i, field_status);
+        if (field_status == STATUS_OK)
+            decoded.humidity[i] = BCD_TABLE.value[raw_data[Layout::HUMIDITY + i * Layout::SENSOR_STRIDE]];
+    }
+
+    /* Pressure */
+    decoded.pressure = 0.0;
+    if ((raw_data[Layout::PRESSURE + 1] & 0xF0) != 0xF0) {
+        decoded.pressure = static_cast<int>(raw_data[Layout::PRESSURE + 1] * 0x100 + raw_data[Layout::PRESSURE]) * 0.0625;
+        set_status(status, available, FIELD_PRESSURE, STATUS_OK);
+    } else {
+        set_status(status, available, FIELD_PRESSURE, STATUS_INVALID);
+    }
+
+    /* Wind chill */
+    digits = raw_data[Layout::WIND_CHILL];
+    flags = raw_data[Layout::WIND_CHILL + 1];
+    field_status = wind_chill_status(digits, flags);
+    set_status(status, available, FIELD_WIND_CHILL, field_status);
+    decoded.wind_chill = field_status == STATUS_OK ? temperature_value(digits, flags) : 0.0f;
+
+    /* Wind gust and speed */
+    gust = wind_status(raw_data[Layout::WIND_GUST], raw_data[Layout::WIND_GUST + 1]);
+    set_status(status, available, FIELD_WIND_GUST, gust);
+    decoded.wind_gust = gust == STATUS_OK ? wind_value(raw_data[Layout::WIND_GUST], raw_data[Layout::WIND_GUST + 1]) : 0.0f;
+
+    speed = wind_status(raw_data[Layout::WIND_SPEED], raw_data[Layout::WIND_SPEED + 1]);
+    set_status(status, available, FIELD_WIND_SPEED, speed);
+    decoded.wind_speed = speed == STATUS_OK ? wind_value(raw_data[Layout::WIND_SPEED], raw_data[Layout::WIND_SPEED + 1]) : 0.0f;
+
+    /* Wind direction, unless the wind sensor is out of range */
+    field_status = wind_dir_status(gust, speed);
+    set_status(status, available, FIELD_WIND_DIR, field_status);
+    decoded.wind_dir = field_status == STATUS_OK ? (float)((raw_data[Layout::WIND_DIR] & 0x0F) * 22.5) : 0.0f;
+
+    /* UV index */
+    digits = raw_data[Layout::UV];
+    flags = raw_data[Layout::UV + 1];
+    field_status = uv_status(digits, flags);
+    set_status(status, available, FIELD_UV, field_status);
+    decoded.uv = field_status == STATUS_OK ? (float)((BCD_TABLE.value[digits] / 10.0) + ((flags & 0x0F) * 10.0)) : 0.0f;
+
+    /* Rain, the station keeps the counter when the rain sensor is lost */
+    set_status(status, available, FIELD_RAIN, STATUS_OK);
+    decoded.rain = (raw_data[Layout::RAIN + 1] * 0x100 + raw_data[Layout::RAIN]) * Layout::RAIN_MM_PER_TIP;
+
+    decoded.status = status;
+    decoded.valid = available;
+
+    return decoded;
+}
+
+/* Decoders of the supported models */
+template DecodedFrame decode_frame<TE923Layout> (const RawFrame& raw_data);
+template uint64_t decode_frame_status<TE923Layout> (const RawFrame& raw_data);
+
+/**
+ * @brief Function to decode every value of a TE923 frame in a single pass
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return DecodedFrame Values decoded, with their valid flags and statuses
+ */
+DecodedFrame decode_frame (const RawFrame& raw_data)
+{
+    return decode_frame<TE923Layout>(raw_data);
+}
+
+/**
+ * @brief Function to get the status of every value of a TE923 frame
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return uint64_t FieldStatus of each value, as DecodedFrame::status
+ */
+uint64_t decode_frame_status (const RawFrame& raw_data)
+{
+    return decode_frame_status<TE923Layout>(raw_data);
+}
+
 /**
  * @brief Function to decode the pressure value obtained
  * 
@@ -29,17 +463,14 @@ float decode_pressure (unsigned char* raw_data)
 {
     float f_press;
 
-    #ifdef DEBUG
-    cout << "[DEBUG] PRS BUF[20]=" << hex << static_cast<int>(raw_data[20]) << " BUF[21]=" << static_cast<int>(raw_data[21]) << dec << endl;
-    #endif
-    if (( raw_data[21] & 0xF0 ) == 0xF0 ) {
-        cerr << "[DEBUG] PRS = 0.0 (No data available)" << endl;
+    LOG_DEBUG("PRS BUF[%d]=%02x BUF[%d]=%02x", TE923Layout::PRESSURE, raw_data[TE923Layout::PRESSURE],
+              TE923Layout::PRESSURE + 1, raw_data[TE923Layout::PRESSURE + 1]);
+    if (( raw_data[TE923Layout::PRESSURE + 1] & 0xF0 ) == 0xF0 ) {
+        count_error(FIELD_PRESSURE, STATUS_INVALID);
         return 0.0;
     } else {
-        f_press = static_cast<int>(raw_data[21] * 0x100 + raw_data[20]) * 0.0625;
-        #ifdef DEBUG
-        cout << "[DEBUG] PRS = " << f_press << endl;
-        #endif
+        f_press = static_cast<int>(raw_data[TE923Layout::PRESSURE + 1] * 0x100 + raw_data[TE923Layout::PRESSURE]) * 0.0625;
+        LOG_DEBUG("PRS = %g", f_press);
         return f_press;
     }
 }
@@ -52,50 +483,67 @@ float decode_pressure (unsigned char* raw_data)
  */
 std::list<float> decode_temperature (unsigned char* raw_data)
 {
-    std::list<float> lcl_temps(0);
-    int data_err = 0;
+    std::array<float, TE923_FRAME_SENSORS> temps;
+
+    decode_temperature(raw_data, temps);
+
+    return std::list<float>(temps.begin(), temps.end());
+}
+
+/**
+ * @brief Function to decode the different temperature values obtained
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @param temps Array where the temperature values are stored
+ */
+void decode_temperature (const unsigned char* raw_data, std::array<float, TE923_FRAME_SENSORS>& temps)
+{
+    decode_temperature(raw_data, temps.data(), TE923_FRAME_SENSORS);
+}
+
+/**
+ * @brief Function to decode the different temperature values obtained
+ * 
+ * Allocation-free version, which stores the values in a buffer of the caller.
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @param temps Buffer where the temperature values are stored
+ * @param count Size of the buffer
+ * @return int Number of values stored (at most TE923_FRAME_SENSORS)
+ */
+int decode_temperature (const unsigned char* raw_data, float* temps, int count)
+{
+    FieldStatus status;
     float tmp_data = 0.0;
 
-    for (int i = 0; i <= 2; i++) {
-		int offset = i * 3;
-        data_err = 0;
+    if (count > TE923_FRAME_SENSORS)
+        count = TE923_FRAME_SENSORS;
+
+    for (int i = 0; i < count; i++) {
+		int offset = TE923Layout::TEMPERATURE + i * TE923Layout::SENSOR_STRIDE;
         tmp_data = 0.0;
 
-        #ifdef DEBUG
-        cout << "[DEBUG] TMP " << i << " BUF[" << 0 + offset << "]=" << hex << raw_data[offset] << " BUF[" << dec << 1 + offset << "]=" << hex << raw_data[1 + offset] << " BUF[" << dec << 2 + offset << "]=" << hex << raw_data[2 + offset] << endl;
-        #endif
-		if (bcd2int(raw_data[offset] & 0x0F) > 9) {
-            cerr << "[DEBUG] TMP buffer 0 & 0x0F > 9" << endl;
-			if (((raw_data[offset] & 0x0F) == 0x0C) || ((raw_data[offset] & 0x0F) == 0x0B)) {
-				cerr << "[DEBUG] TMP buffer 0 & 0x0F = (0x0C or 0x0B)" << endl;
-                data_err = -2;
-			} else {
-				cerr << "[DEBUG] TMP other error in buffer 0" << endl;
-                data_err = -1;
-			}
-		}
-		if (((raw_data[1 + offset] & 0x40) != 0x40) && i > 0) {
-			cerr << "[DEBUG] TMP buffer 1 bit 6 set" << endl;
-            data_err = -2;
-		}
-
-		if (!data_err) {
-			tmp_data = (bcd2int(raw_data[offset]) / 10.0) + (bcd2int(raw_data[1 + offset] & 0x0F) * 10.0);
+        LOG_DEBUG("TMP %d BUF[%d]=%02x BUF[%d]=%02x BUF[%d]=%02x", i, offset, raw_data[offset],
+                  1 + offset, raw_data[1 + offset], 2 + offset, raw_data[2 + offset]);
+        status = temperature_status(raw_data[offset], raw_data[1 + offset], i);
+
+		if (status == STATUS_OK) {
+			tmp_data = (BCD_TABLE.value[raw_data[offset]] / 10.0) + ((raw_data[1 + offset] & 0x0F) * 10.0);
 			
 			if ((raw_data[1 + offset] & 0x20) == 0x20)
 				tmp_data += 0.05;
 			if ((raw_data[1 + offset] & 0x80) != 0x80)
 				tmp_data *= -1;
 
-            #ifdef DEBUG
-			cout << "[DEBUG] TMP " << i << " is " << tmp_data << endl;
-            #endif
-		}
+			LOG_DEBUG("TMP %d is %g", i, tmp_data);
+		} else {
+            count_error(FIELD_TEMPERATURE + i, status);
+        }
 
-        lcl_temps.push_back(tmp_data);
+        temps[i] = tmp_data;
 	}
 
-    return lcl_temps;
+    return count;
 }
 
 /**
@@ -106,46 +554,62 @@ std::list<float> decode_temperature (unsigned char* raw_data)
  */
 std::list<float> decode_humidity (unsigned char* raw_data)
 {
-    std::list<float> lcl_hums(0);
-    int data_err = 0;
+    std::array<float, TE923_FRAME_SENSORS> hums;
+
+    decode_humidity(raw_data, hums);
+
+    return std::list<float>(hums.begin(), hums.end());
+}
+
+/**
+ * @brief Function to decode the different humidity values obtained
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @param hums Array where the humidity values are stored
+ */
+void decode_humidity (const unsigned char* raw_data, std::array<float, TE923_FRAME_SENSORS>& hums)
+{
+    decode_humidity(raw_data, hums.data(), TE923_FRAME_SENSORS);
+}
+
+/**
+ * @brief Function to decode the different humidity values obtained
+ * 
+ * Allocation-free version, which stores the values in a buffer of the caller.
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @param hums Buffer where the humidity values are stored
+ * @param count Size of the buffer
+ * @return int Number of values stored (at most TE923_FRAME_SENSORS)
+ */
+int decode_humidity (const unsigned char* raw_data, float* hums, int count)
+{
+    FieldStatus status;
     float tmp_humid = 0.0;
 
-    for (int i = 0; i <= 2; i++) {
-		int offset = i * 3;
-        data_err = 0;
+    if (count > TE923_FRAME_SENSORS)
+        count = TE923_FRAME_SENSORS;
+
+    for (int i = 0; i < count; i++) {
+		int offset = TE923Layout::TEMPERATURE + i * TE923Layout::SENSOR_STRIDE;
+        int humidity = TE923Layout::HUMIDITY + i * TE923Layout::SENSOR_STRIDE;
         tmp_humid = 0.0;
 
-        if (bcd2int(raw_data[offset] & 0x0F) > 9) {
-            cerr << "[DEBUG] TMP buffer 0 & 0x0F > 9" << endl;
-            if (((raw_data[offset] & 0x0F) == 0x0C) || ((raw_data[offset] & 0x0F) == 0x0B)) {
-                cerr << "[DEBUG] TMP buffer 0 & 0x0F = (0x0C or 0x0B)" << endl;
-                data_err = -2;
-            } else {
-                cerr << "[DEBUG] TMP other error in buffer 0" << endl;
-                data_err = -1;
-            }
-        }
-        if (((raw_data[1 + offset] & 0x40) != 0x40) && i > 0) {
-            cerr << "[DEBUG] TMP buffer 1 bit 6 set" << endl;
-            data_err = -2;
-        }
+        status = humidity_status(raw_data[offset], raw_data[1 + offset], raw_data[humidity], i,
+                                 temperature_status(raw_data[offset], raw_data[1 + offset], i));
 
-        if (data_err <= -2) {
-			cerr << "[DEBUG] HMY error. Data not valid" << endl;
-		} else if (bcd2int(raw_data[2 + offset] & 0x0F) > 9) {
-			cerr << "[DEBUG] HMY buffer 0 & 0x0F > 9" << endl;
-		} else {
-            tmp_humid = bcd2int(raw_data[2 + offset]);
+        if (status == STATUS_OK) {
+            tmp_humid = BCD_TABLE.value[raw_data[humidity]];
 			
-            #ifdef DEBUG
-			cout << "[DEBUG] HMY " << i << " is " << tmp_humid << endl;
-            #endif
-		}
+			LOG_DEBUG("HMY %d is %g", i, tmp_humid);
+		} else {
+            count_error(FIELD_HUMIDITY + i, status);
+        }
 
-        lcl_hums.push_back(tmp_humid);
+        hums[i] = tmp_humid;
     }
 
-    return lcl_hums;
+    return count;
 }
 
 /**
@@ -157,30 +621,18 @@ std::list<float> decode_humidity (unsigned char* raw_data)
 float decode_wind_chill (unsigned char* raw_data)
 {
     float f_wind_chill = 0.0;
-    int data_err = 0;
-
-    // Part 1: Error management
-    if ((bcd2int(raw_data[23] & 0xF0) > 90) || (bcd2int(raw_data[23] & 0x0F) > 9)) {
-		if ((raw_data[23] == 0xAA) && (raw_data[24] == 0x8A))
-			data_err = -1;
-		else if ((raw_data[23] == 0xBB) && (raw_data[24] == 0x8B))
-			data_err = -2;
-		else if ((raw_data[23] == 0xEE) && (raw_data[24] == 0x8E))
-			data_err = -3;
-		else
-			data_err = -4;
-	}
-    if (((raw_data[24] & 0x40) != 0x40))
-		data_err = -2;
+    const unsigned char* chill = raw_data + TE923Layout::WIND_CHILL;
+    FieldStatus status = wind_chill_status(chill[0], chill[1]);
 
-    // Part 2: Data Adquisition
-	if (data_err == 0) {
-        f_wind_chill = (bcd2int(raw_data[23]) / 10.0) + (bcd2int(raw_data[24] & 0x0F) * 10.0);
-		if ((raw_data[24] & 0x20) == 0x20)
+	if (status == STATUS_OK) {
+        f_wind_chill = (BCD_TABLE.value[chill[0]] / 10.0) + ((chill[1] & 0x0F) * 10.0);
+		if ((chill[1] & 0x20) == 0x20)
 			f_wind_chill += 0.05;
-		if ((raw_data[24] & 0x80) != 0x80)
+		if ((chill[1] & 0x80) != 0x80)
 			f_wind_chill *= -1;
-	}
+	} else {
+        count_error(FIELD_WIND_CHILL, status);
+    }
 
     return f_wind_chill;
 }
@@ -194,27 +646,19 @@ float decode_wind_chill (unsigned char* raw_data)
 float decode_wind_gust (unsigned char* raw_data)
 {
     float f_wind_gust = 0.0;
-    int data_err = 0;
     int offset = 0;
+    const unsigned char* gust = raw_data + TE923Layout::WIND_GUST;
+    FieldStatus status = wind_status(gust[0], gust[1]);
 
-    #ifdef DEBUG
-	cout <<	"[DEBUG] WGS BUF[25]=" << hex << raw_data[25] << " BUF[26]=" << raw_data[26] << dec << endl;
-    #endif
-	if ((bcd2int(raw_data[25] & 0xF0) > 90) || (bcd2int(raw_data[25] & 0x0F) > 9)) {
-		data_err = -1;
-		if ((raw_data[25] == 0xBB) && (raw_data[26] == 0x8B))
-			data_err = -2;
-		else if ((raw_data[25] == 0xEE) && (raw_data[26] == 0x8E))
-			data_err = -3;
-		else
-			data_err = -4;
-	}
+	LOG_DEBUG("WGS BUF[%d]=%02x BUF[%d]=%02x", TE923Layout::WIND_GUST, gust[0], TE923Layout::WIND_GUST + 1, gust[1]);
 
-	if (data_err == 0) {
-		if ((raw_data[26] & 0x10) == 0x10)
+	if (status == STATUS_OK) {
+		if ((gust[1] & 0x10) == 0x10)
 			offset = 100;
-		f_wind_gust = ((bcd2int(raw_data[25]) / 10.0) + (bcd2int(raw_data[26] & 0x0F) * 10.0) + offset) / 2.23694;
-	}
+		f_wind_gust = ((BCD_TABLE.value[gust[0]] / 10.0) + ((gust[1] & 0x0F) * 10.0) + offset) / 2.23694;
+	} else {
+        count_error(FIELD_WIND_GUST, status);
+    }
 
     return f_wind_gust * 3.6;
 }
@@ -229,26 +673,18 @@ float decode_wind_speed (unsigned char* raw_data)
 {
     float f_wind_speed = 0.0;
     int offset = 0;
-    int data_err = 0;
-
-    #ifdef DEBUG
-    cout << "[DEBUG] WSP BUF[27]=" << hex << raw_data[27] << " BUF[28]=" << raw_data[28] << dec << endl;
-    #endif
-	if ((bcd2int(raw_data[27] & 0xF0) > 90) || (bcd2int(raw_data[27] & 0x0F) > 9)) {
-		data_err = -1;
-		if ((raw_data[27] == 0xBB) && (raw_data[28] == 0x8B))
-			data_err = -2;
-		else if ((raw_data[27] == 0xEE) && (raw_data[28] == 0x8E))
-			data_err = -3;
-		else
-			data_err = -4;
-	}
+    const unsigned char* speed = raw_data + TE923Layout::WIND_SPEED;
+    FieldStatus status = wind_status(speed[0], speed[1]);
+
+    LOG_DEBUG("WSP BUF[%d]=%02x BUF[%d]=%02x", TE923Layout::WIND_SPEED, speed[0], TE923Layout::WIND_SPEED + 1, speed[1]);
 
-	if (data_err == 0) {
-		if ((raw_data[28] & 0x10) == 0x10)
+	if (status == STATUS_OK) {
+		if ((speed[1] & 0x10) == 0x10)
 			offset = 100;
-		f_wind_speed = ((bcd2int(raw_data[27]) / 10.0) + (bcd2int(raw_data[28] & 0x0F) * 10.0) + offset) / 2.23694;
-	}
+		f_wind_speed = ((BCD_TABLE.value[speed[0]] / 10.0) + ((speed[1] & 0x0F) * 10.0) + offset) / 2.23694;
+	} else {
+        count_error(FIELD_WIND_SPEED, status);
+    }
 
     return f_wind_speed * 3.6;
 }
@@ -262,53 +698,131 @@ float decode_wind_speed (unsigned char* raw_data)
 float decode_wind_dir (unsigned char* raw_data)
 {
     float f_wind_dir = 0;
-    int data_err_gust = 0;
-    int data_err_speed = 0;
-    int data_err = 0;
-
-    #ifdef DEBUG
-    cout << "[DEBUG] WDR BUF[29]=" << hex << raw_data[29] << dec << endl;
-	#endif
-
-    if ((bcd2int(raw_data[25] & 0xF0) > 90) || (bcd2int(raw_data[25] & 0x0F) > 9)) {
-		data_err_gust = -1;
-		if ((raw_data[25] == 0xBB) && (raw_data[26] == 0x8B))
-			data_err_gust = -2;
-		else if ((raw_data[25] == 0xEE) && (raw_data[26] == 0x8E))
-			data_err_gust = -3;
-		else
-			data_err_gust = -4;
-	}
-    if ((bcd2int(raw_data[27] & 0xF0) > 90) || (bcd2int(raw_data[27] & 0x0F) > 9)) {
-		data_err_speed = -1;
-		if ((raw_data[27] == 0xBB) && (raw_data[28] == 0x8B))
-			data_err_speed = -2;
-		else if ((raw_data[27] == 0xEE) && (raw_data[28] == 0x8E))
-			data_err_speed = -3;
-		else
-			data_err_speed = -4;
-	}
-	if ((data_err_gust <= -3) || (data_err_speed <= -3)) {
-		data_err = -3;
-	}
+    const unsigned char* gust = raw_data + TE923Layout::WIND_GUST;
+    const unsigned char* speed = raw_data + TE923Layout::WIND_SPEED;
+    FieldStatus status = wind_dir_status(wind_status(gust[0], gust[1]), wind_status(speed[0], speed[1]));
+
+    LOG_DEBUG("WDR BUF[%d]=%02x", TE923Layout::WIND_DIR, raw_data[TE923Layout::WIND_DIR]);
 
-    if (data_err == 0)
+    if (status == STATUS_OK)
     {
-		f_wind_dir = ((int)raw_data[29] & 0x0F) * 22.5;
-	}
+		f_wind_dir = ((int)raw_data[TE923Layout::WIND_DIR] & 0x0F) * 22.5;
+	} else {
+        count_error(FIELD_WIND_DIR, status);
+    }
 
     return f_wind_dir;
 }
 
+/**
+ * @brief Function to decode the UV index of the station
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return float UV index decoded
+ */
+float decode_uv (unsigned char* raw_data)
+{
+    float f_uv = 0.0;
+    const unsigned char* uv = raw_data + TE923Layout::UV;
+    FieldStatus status = uv_status(uv[0], uv[1]);
+
+    LOG_DEBUG("UV BUF[%d]=%02x BUF[%d]=%02x", TE923Layout::UV, uv[0], TE923Layout::UV + 1, uv[1]);
+
+    if (status == STATUS_OK) {
+        f_uv = (BCD_TABLE.value[uv[0]] / 10.0) + ((uv[1] & 0x0F) * 10.0);
+    } else {
+        count_error(FIELD_UV, status);
+    }
+
+    return f_uv;
+}
+
+/**
+ * @brief Function to decode the rain since the station was reset
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return float Rain in mm
+ */
+float decode_rain (unsigned char* raw_data)
+{
+    int tips = raw_data[TE923Layout::RAIN + 1] * 0x100 + raw_data[TE923Layout::RAIN];
+
+    LOG_DEBUG("RAIN BUF[%d]=%02x BUF[%d]=%02x", TE923Layout::RAIN, raw_data[TE923Layout::RAIN],
+              TE923Layout::RAIN + 1, raw_data[TE923Layout::RAIN + 1]);
+
+    return tips * TE923Layout::RAIN_MM_PER_TIP;
+}
+
+/**
+ * @brief Function to check the XOR CRC of a frame
+ * 
+ * The byte 33 of the frame is the XOR of the bytes 0 to 32. A XOR of 0x5a is
+ * also accepted, as sent by some stations.
+ * 
+ * @param raw_data Raw buffer obtained from the USB device
+ * @return true The frame is valid
+ * @return false The CRC does not match
+ */
+bool check_crc (unsigned char* raw_data)
+{
+    unsigned char crc = 0x00;
+
+    for (int i = 0; i < TE923Layout::CRC; i++) {
+        crc = crc ^ raw_data[i];
+    }
+
+    return (crc == raw_data[TE923Layout::CRC]) || (crc == 0x5a);
+}
+
+/**
+ * @brief Get the counters of the values not available
+ * 
+ * @return DecodeDiagnostics& Counters shared by every decoder
+ */
+DecodeDiagnostics& decode_diagnostics ()
+{
+    return diagnostics;
+}
+
+/**
+ * @brief Print the counters of the values not available
+ * 
+ * Only the counters different from 0 are printed, one line per field.
+ * 
+ * @param out Stream where the counters are printed
+ */
+void dump_decode_diagnostics (std::ostream& out)
+{
+    unsigned long count;
+    bool printed;
+
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        printed = false;
+        for (int status = STATUS_NO_LINK; status < STATUS_COUNT; status++) {
+            count = diagnostics.errors[field][status].load(memory_order_relaxed);
+            if (count == 0)
+                continue;
+            if (printed)
+                out << ", ";
+            else
+                out << "Missing " << FIELD_NAMES[field] << ": ";
+            out << STATUS_NAMES[status] << " " << count;
+            printed = true;
+        }
+        if (printed)
+            out << '\n';
+    }
+}
+
 /**
  * @brief Function to transform a sigle character from BCD to Integer
  * 
  * This function transforms a single character coded in BCD into a integer
- * applying a fixed transformation.
+ * looking it up in the BCD table.
  * 
  * @param bcd Character to transform
  * @return int Integer representation of the character
  */
 int bcd2int(char bcd) {
-	return ((int)((bcd & 0xF0) >> 4) * 10 + (int)(bcd & 0x0F));
+	return BCD_TABLE.value[(uint8_t)bcd];
 }
\ No newline at end of file
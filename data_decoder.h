@@ -11,14 +11,207 @@
  * from the USB device into a readable and usable format.
  */
 
+#ifndef DATA_DECODER_H
+#define DATA_DECODER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <list>
+#include <ostream>
+
+#include "frame_layout.h"
+
+/**
+ * @brief Size of the data buffer where USB data is stored
+ */
+const int BUFLEN = 35;
+/// Number of temperature and humidity channels of a frame (0 is the indoor one).
+const int TE923_FRAME_SENSORS = 6;
+
+/// Raw frame of the current readings of the station.
+typedef uint8_t RawFrame[BUFLEN];
+
+/**
+ * @brief Position of each value of a frame in the valid and status masks
+ */
+enum DecodedField {
+    /// Temperature of the first sensor (plus the number of sensor).
+    FIELD_TEMPERATURE = 0,
+    /// Humidity of the first sensor (plus the number of sensor).
+    FIELD_HUMIDITY = TE923_FRAME_SENSORS,
+    /// Pressure.
+    FIELD_PRESSURE = 2 * TE923_FRAME_SENSORS,
+    /// Wind chill.
+    FIELD_WIND_CHILL,
+    /// Wind gust.
+    FIELD_WIND_GUST,
+    /// Wind speed.
+    FIELD_WIND_SPEED,
+    /// Wind direction.
+    FIELD_WIND_DIR,
+    /// UV index.
+    FIELD_UV,
+    /// Rain counter.
+    FIELD_RAIN,
+    /// Number of values of a frame.
+    FIELD_COUNT
+};
+
+/**
+ * @brief Status of a value decoded from a frame
+ */
+enum FieldStatus {
+    /// The value is available.
+    STATUS_OK = 0,
+    /// The station has no link with the sensor.
+    STATUS_NO_LINK,
+    /// The sensor was lost (or its reading is not ready).
+    STATUS_SENSOR_LOST,
+    /// The reading is out of the range of the sensor.
+    STATUS_OUT_OF_RANGE,
+    /// The bytes of the value are not valid.
+    STATUS_INVALID,
+    /// Number of statuses.
+    STATUS_COUNT
+};
+
+/// Bits of the status of each field in DecodedFrame::status.
+const int FIELD_STATUS_BITS = 3;
+
+static_assert(STATUS_COUNT <= (1 << FIELD_STATUS_BITS), "FIELD_STATUS_BITS is too small for the statuses");
+static_assert(FIELD_COUNT * FIELD_STATUS_BITS <= 64, "The statuses of a frame do not fit in DecodedFrame::status");
+
+/// Valid flag of the temperature of the first sensor (shifted by sensor).
+const uint32_t DECODED_TEMPERATURE = 1 << FIELD_TEMPERATURE;
+/// Valid flag of the humidity of the first sensor (shifted by sensor).
+const uint32_t DECODED_HUMIDITY = 1 << FIELD_HUMIDITY;
+/// Valid flag of the pressure.
+const uint32_t DECODED_PRESSURE = 1 << FIELD_PRESSURE;
+/// Valid flag of the wind chill.
+const uint32_t DECODED_WIND_CHILL = 1 << FIELD_WIND_CHILL;
+/// Valid flag of the wind gust.
+const uint32_t DECODED_WIND_GUST = 1 << FIELD_WIND_GUST;
+/// Valid flag of the wind speed.
+const uint32_t DECODED_WIND_SPEED = 1 << FIELD_WIND_SPEED;
+/// Valid flag of the wind direction.
+const uint32_t DECODED_WIND_DIR = 1 << FIELD_WIND_DIR;
+/// Valid flag of the UV index.
+const uint32_t DECODED_UV = 1 << FIELD_UV;
+/// Valid flag of the rain.
+const uint32_t DECODED_RAIN = 1 << FIELD_RAIN;
+/// Valid flags of a frame with every value available.
+const uint32_t DECODED_ALL = (1 << FIELD_COUNT) - 1;
+
+/**
+ * @brief Values decoded from a frame
+ *
+ * Plain structure filled by decode_frame(). The values not available in the
+ * frame are 0, their flag is not set in valid and the reason is kept in
+ * status.
+ */
+struct DecodedFrame {
+    /// Temperatures of the channels, in ºC.
+    float temperature[TE923_FRAME_SENSORS];
+    /// Humidities of the channels, in %.
+    float humidity[TE923_FRAME_SENSORS];
+    /// Pressure in mb.
+    float pressure;
+    /// Wind chill in ºC.
+    float wind_chill;
+    /// Wind gust in kmh.
+    float wind_gust;
+    /// Wind speed in kmh.
+    float wind_speed;
+    /// Wind direction in degrees.
+    float wind_dir;
+    /// UV index of the UV sensor of the station.
+    float uv;
+    /// Rain since the station was reset, in mm.
+    float rain;
+    /// DECODED_* flags of the values available.
+    uint32_t valid;
+    /// FieldStatus of each value, FIELD_STATUS_BITS bits per DecodedField.
+    uint64_t status;
+};
+
+/**
+ * @brief Number of values decoded with each error status
+ *
+ * Shared by every decoder and every thread. Only the values not available
+ * are counted, so decoding a valid frame does not touch the counters.
+ */
+struct DecodeDiagnostics {
+    /// Values not available, by DecodedField and FieldStatus.
+    std::atomic<unsigned long> errors[FIELD_COUNT][STATUS_COUNT];
+};
+
+/**
+ * @brief Get the status of a value from a status mask
+ *
+ * @param status FieldStatus of each value, as DecodedFrame::status
+ * @param field DecodedField of the value
+ * @return FieldStatus Status of the value
+ */
+inline FieldStatus get_field_status(uint64_t status, int field) {
+    return (FieldStatus)((status >> (field * FIELD_STATUS_BITS)) & ((1 << FIELD_STATUS_BITS) - 1));
+}
+
+/**
+ * @brief Get the status of a value of a decoded frame
+ *
+ * @param decoded Decoded frame
+ * @param field DecodedField of the value
+ * @return FieldStatus Status of the value
+ */
+inline FieldStatus get_field_status(const DecodedFrame& decoded, int field) {
+    return get_field_status(decoded.status, field);
+}
+
+/**
+ * @brief Status of the wind direction
+ *
+ * The direction is kept while the wind sensor is only lost, and follows the
+ * error of the gust or the speed otherwise.
+ *
+ * @param gust Status of the wind gust
+ * @param speed Status of the wind speed
+ * @return FieldStatus Status of the wind direction
+ */
+inline FieldStatus wind_dir_status(FieldStatus gust, FieldStatus speed) {
+    if (gust != STATUS_OK && gust != STATUS_SENSOR_LOST)
+        return gust;
+    if (speed != STATUS_OK && speed != STATUS_SENSOR_LOST)
+        return speed;
+    return STATUS_OK;
+}
+
+template<typename Layout> DecodedFrame decode_frame (const RawFrame& raw_data);
+extern template DecodedFrame decode_frame<TE923Layout> (const RawFrame& raw_data);
+DecodedFrame decode_frame (const RawFrame& raw_data);
+template<typename Layout> uint64_t decode_frame_status (const RawFrame& raw_data);
+extern template uint64_t decode_frame_status<TE923Layout> (const RawFrame& raw_data);
+uint64_t decode_frame_status (const RawFrame& raw_data);
 
 float decode_pressure (unsigned char* raw_data);
 std::list<float> decode_temperature (unsigned char* raw_data);
+void decode_temperature (const unsigned char* raw_data, std::array<float, TE923_FRAME_SENSORS>& temps);
+int decode_temperature (const unsigned char* raw_data, float* temps, int count);
 std::list<float> decode_humidity (unsigned char* raw_data);
+void decode_humidity (const unsigned char* raw_data, std::array<float, TE923_FRAME_SENSORS>& hums);
+int decode_humidity (const unsigned char* raw_data, float* hums, int count);
 float decode_wind_chill (unsigned char* raw_data);
 float decode_wind_gust (unsigned char* raw_data);
 float decode_wind_speed (unsigned char* raw_data);
 float decode_wind_dir (unsigned char* raw_data);
+float decode_uv (unsigned char* raw_data);
+float decode_rain (unsigned char* raw_data);
+
+bool check_crc (unsigned char* raw_data);
+
+DecodeDiagnostics& decode_diagnostics ();
+void dump_decode_diagnostics (std::ostream& out);
+
+int bcd2int(char bcd);
 
-int bcd2int(char bcd);
\ No newline at end of file
+#endif
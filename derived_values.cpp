@@ -0,0 +1,346 @@
+/**
+ * @file derived_values.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Library to calculate the values derived from an observation
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Kernels of the calculations of Observation and ObservationBatch, without
+ * pow(). The humidity of the station is an integer from 0 to 99, so the root
+ * of the dew point formula is read from a table built with the original
+ * pow() expression, which gives the same bits. Any other humidity uses three
+ * chained square roots, within DEW_POINT_ROOT_TOLERANCE of pow().
+ *
+ * The RealFeel© kernel has no branches: both ways of the patent formula are
+ * calculated with the square roots they share and the result is selected,
+ * and the clamps of the wind speed and the dew point are min/max. The batch
+ * kernels run it 4 (SSE2) or 8 (AVX) observations at a time on x86, and the
+ * rest of the batch with the same operations in scalar code, so every
+ * observation gets the same value wherever it is in the batch.
+ */
+
+#include "derived_values.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/// Kilometres of a mile.
+const float KM_PER_MILE = 1.609;
+
+/**
+ * @brief Dew point root of every integer humidity
+ *
+ * Filled when the program starts, with the expression the dew point used
+ * before the table.
+ */
+static struct DewPointTable {
+    /// pow(humidity / 100, 0.125) of each humidity.
+    float root[DEW_POINT_TABLE_SIZE];
+
+    DewPointTable()
+    {
+        for (int h = 0; h < DEW_POINT_TABLE_SIZE; h++)
+            root[h] = pow((float)h / 100, 0.125);
+    }
+} dew_point_table;
+
+/**
+ * @brief Function to calculate the root of the dew point formula
+ *
+ * Same as pow(humidity / 100, 0.125), exactly for the integer humidities
+ * from 0 to 99 and within DEW_POINT_ROOT_TOLERANCE for the rest.
+ *
+ * @param humidity Relative humidity, in %
+ * @return float Root of the humidity
+ */
+float dew_point_root (float humidity)
+{
+    if (humidity >= 0 && humidity < DEW_POINT_TABLE_SIZE) {
+        int index = (int)humidity;
+
+        if (index == humidity)
+            return dew_point_table.root[index];
+    }
+
+    return sqrt(sqrt(sqrt((double)(humidity / 100))));
+}
+
+/**
+ * @brief Function to calculate the dew point
+ *
+ * Same formula and precision as Observation::calculateDewPoint() always
+ * used, with pow() replaced by dew_point_root().
+ *
+ * @param temperature Temperature, in ºC
+ * @param humidity Relative humidity, in %
+ * @return float Dew point, in ºC
+ */
+float calculate_dew_point (float temperature, float humidity)
+{
+    float dew_point = dew_point_root(humidity);
+
+    dew_point *= (112 + (0.9 * temperature));
+    dew_point -= 112;
+
+    return dew_point;
+}
+
+/**
+ * @brief Dew point in single precision, as the batch kernels calculate it
+ *
+ * @param temperature Temperature, in ºC
+ * @param humidity Relative humidity, in %
+ * @return float Dew point, in ºC
+ */
+static inline float batch_dew_point(float temperature, float humidity)
+{
+    float root = sqrtf(sqrtf(sqrtf(humidity / 100)));
+
+    return root * (112 + 0.9f * temperature) - 112;
+}
+
+/**
+ * @brief RealFeel© of an observation, without branches
+ *
+ * Steps of the patent: the wind (WSP) and the humidity (H) terms of both
+ * ways are calculated, sharing the square roots of the wind speed and the
+ * pressure, and the way is chosen by the temperature (T1 > 65 ºF). The wind
+ * speed is clamped as min(max(WS, WS / 2 + 2), 56), which is the same as the
+ * three cases of the patent, and the dew point as max(DP - 55 - sqrt(WS), 0).
+ * The solar (SI) term is the UV index and the precipitation (P) is 0.
+ *
+ * @param temperature Temperature, in ºC
+ * @param dew_point Dew point, in ºC
+ * @param wind_speed Wind speed, in kmh
+ * @param pressure Pressure, in mb
+ * @param uv_index UV index
+ * @return float RealFeel©, in ºC
+ */
+static inline float real_feel_kernel(float temperature, float dew_point, float wind_speed, float pressure, float uv_index)
+{
+    float temp_f = temperature * 9 / 5 + 32;
+    float dew_point_f = dew_point * 9 / 5 + 32;
+    float wind_mph = wind_speed / KM_PER_MILE;
+    float wind_root = sqrtf(wind_mph);
+    float pressure_root = sqrtf(pressure / 10) / 10;
+    float w_a = fminf(fmaxf(wind_mph, wind_mph / 2 + 2), 56);
+    float hot = 80 - (80 - temp_f) * (0.566f + 0.25f * sqrtf(w_a) - 0.0166f * w_a) * pressure_root;
+    float cold = temp_f - wind_root * pressure_root;
+    float humid = fmaxf(dew_point_f - (55 + wind_root), 0);
+    float mft = (temp_f > 65 ? hot : cold) + uv_index + humid * humid / 30;
+
+    return (mft - 32) * 5 / 9;
+}
+
+/**
+ * @brief Function to calculate the RealFeel© value
+ *
+ * @param temperature Temperature, in ºC
+ * @param dew_point Dew point, in ºC
+ * @param wind_speed Wind speed, in kmh
+ * @param pressure Pressure, in mb
+ * @param uv_index UV index
+ * @return float RealFeel©, in ºC
+ */
+float calculate_real_feel (float temperature, float dew_point, float wind_speed, float pressure, int uv_index)
+{
+    return real_feel_kernel(temperature, dew_point, wind_speed, pressure, uv_index);
+}
+
+#if defined(__SSE2__)
+
+#if defined(__AVX__)
+
+/// Floats of a vector.
+typedef __m256 vfloat;
+/// Number of floats of a vfloat.
+const int VF_LANES = 8;
+
+static inline vfloat vf_load(const float* src) { return _mm256_loadu_ps(src); }
+static inline void vf_store(float* dst, vfloat a) { _mm256_storeu_ps(dst, a); }
+static inline vfloat vf_set(float value) { return _mm256_set1_ps(value); }
+static inline vfloat vf_add(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat vf_sub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat vf_mul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat vf_div(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+static inline vfloat vf_sqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+static inline vfloat vf_min(vfloat a, vfloat b) { return _mm256_min_ps(a, b); }
+static inline vfloat vf_max(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+static inline vfloat vf_lt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vfloat vf_gt(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline vfloat vf_ge(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline vfloat vf_eq(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline vfloat vf_and(vfloat a, vfloat b) { return _mm256_and_ps(a, b); }
+static inline vfloat vf_select(vfloat mask, vfloat a, vfloat b) { return _mm256_blendv_ps(b, a, mask); }
+static inline vfloat vf_trunc(vfloat a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+#else
+
+/// Floats of a vector.
+typedef __m128 vfloat;
+/// Number of floats of a vfloat.
+const int VF_LANES = 4;
+
+static inline vfloat vf_load(const float* src) { return _mm_loadu_ps(src); }
+static inline void vf_store(float* dst, vfloat a) { _mm_storeu_ps(dst, a); }
+static inline vfloat vf_set(float value) { return _mm_set1_ps(value); }
+static inline vfloat vf_add(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vf_sub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vf_mul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vf_div(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vfloat vf_sqrt(vfloat a) { return _mm_sqrt_ps(a); }
+static inline vfloat vf_min(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+static inline vfloat vf_max(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+static inline vfloat vf_lt(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+static inline vfloat vf_gt(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+static inline vfloat vf_ge(vfloat a, vfloat b) { return _mm_cmpge_ps(a, b); }
+static inline vfloat vf_eq(vfloat a, vfloat b) { return _mm_cmpeq_ps(a, b); }
+static inline vfloat vf_and(vfloat a, vfloat b) { return _mm_and_ps(a, b); }
+static inline vfloat vf_select(vfloat mask, vfloat a, vfloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline vfloat vf_trunc(vfloat a)
+{
+    // Only the values below 2^23 have decimals, the rest are kept as they are
+    vfloat truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    vfloat big = _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), a), _mm_set1_ps(8388608.0f));
+    return vf_select(big, a, truncated);
+}
+
+#endif
+
+/**
+ * @brief Dew points of a vector of observations, as batch_dew_point()
+ */
+static inline vfloat vf_dew_point(vfloat temperature, vfloat humidity)
+{
+    vfloat root = vf_sqrt(vf_sqrt(vf_sqrt(vf_div(humidity, vf_set(100)))));
+
+    return vf_sub(vf_mul(root, vf_add(vf_set(112), vf_mul(vf_set(0.9f), temperature))), vf_set(112));
+}
+
+/**
+ * @brief RealFeel© of a vector of observations, as real_feel_kernel()
+ */
+static inline vfloat vf_real_feel(vfloat temperature, vfloat dew_point, vfloat wind_speed, vfloat pressure, vfloat uv_index)
+{
+    vfloat temp_f = vf_add(vf_div(vf_mul(temperature, vf_set(9)), vf_set(5)), vf_set(32));
+    vfloat dew_point_f = vf_add(vf_div(vf_mul(dew_point, vf_set(9)), vf_set(5)), vf_set(32));
+    vfloat wind_mph = vf_div(wind_speed, vf_set(KM_PER_MILE));
+    vfloat wind_root = vf_sqrt(wind_mph);
+    vfloat pressure_root = vf_div(vf_sqrt(vf_div(pressure, vf_set(10))), vf_set(10));
+    vfloat w_a = vf_min(vf_max(wind_mph, vf_add(vf_div(wind_mph, vf_set(2)), vf_set(2))), vf_set(56));
+    vfloat wind_factor = vf_sub(vf_add(vf_set(0.566f), vf_mul(vf_set(0.25f), vf_sqrt(w_a))), vf_mul(vf_set(0.0166f), w_a));
+    vfloat hot = vf_sub(vf_set(80), vf_mul(vf_mul(vf_sub(vf_set(80), temp_f), wind_factor), pressure_root));
+    vfloat cold = vf_sub(temp_f, vf_mul(wind_root, pressure_root));
+    vfloat humid = vf_max(vf_sub(dew_point_f, vf_add(vf_set(55), wind_root)), vf_set(0));
+    vfloat mft = vf_select(vf_gt(temp_f, vf_set(65)), hot, cold);
+
+    mft = vf_add(vf_add(mft, uv_index), vf_div(vf_mul(humid, humid), vf_set(30)));
+    return vf_div(vf_mul(vf_sub(mft, vf_set(32)), vf_set(5)), vf_set(9));
+}
+
+/**
+ * @brief UV indexes of a vector rounded half away from zero, as lround()
+ */
+static inline vfloat vf_round_uv(vfloat uv_index)
+{
+    vfloat zero = vf_set(0);
+    vfloat half = vf_set(0.5f);
+    vfloat rounded = vf_trunc(uv_index);
+    vfloat fraction = vf_sub(uv_index, rounded);
+
+    rounded = vf_add(rounded, vf_and(vf_ge(fraction, half), vf_set(1)));
+    return vf_sub(rounded, vf_and(vf_ge(vf_sub(zero, fraction), half), vf_set(1)));
+}
+
+#endif
+
+/**
+ * @brief Function to calculate the dew points of a batch of observations
+ *
+ * Same as calculate_dew_point() within BATCH_DEW_POINT_TOLERANCE. As in
+ * Observation, the observations with the temperature and the humidity at 0
+ * keep their dew point.
+ *
+ * @param temperature Temperature of each observation, in ºC
+ * @param humidity Relative humidity of each observation, in %
+ * @param dew_point Dew point of each observation, in ºC
+ * @param count Number of observations
+ */
+void calculate_dew_points (const float* temperature, const float* humidity, float* dew_point, size_t count)
+{
+    size_t f = 0;
+
+#if defined(__SSE2__)
+    vfloat zero = vf_set(0);
+
+    for (; f + VF_LANES <= count; f += VF_LANES) {
+        vfloat temp = vf_load(temperature + f);
+        vfloat hum = vf_load(humidity + f);
+        vfloat skip = vf_and(vf_eq(temp, zero), vf_eq(hum, zero));
+
+        vf_store(dew_point + f, vf_select(skip, vf_load(dew_point + f), vf_dew_point(temp, hum)));
+    }
+#endif
+
+    for (; f < count; f++) {
+        if (temperature[f] == 0 && humidity[f] == 0)
+            continue;
+        dew_point[f] = batch_dew_point(temperature[f], humidity[f]);
+    }
+}
+
+/**
+ * @brief Function to calculate the RealFeel© values of a batch of observations
+ *
+ * The dew points are calculated too, as calculate_dew_points(), and the UV
+ * indexes are rounded as lround(). Same as calculate_real_feel() within
+ * BATCH_REAL_FEEL_TOLERANCE. As in Observation, the observations with the
+ * temperature and the humidity at 0 keep their dew point and RealFeel©.
+ *
+ * @param temperature Temperature of each observation, in ºC
+ * @param humidity Relative humidity of each observation, in %
+ * @param wind_speed Wind speed of each observation, in kmh
+ * @param pressure Pressure of each observation, in mb
+ * @param uv_index UV index of each observation
+ * @param dew_point Dew point of each observation, in ºC
+ * @param real_feel RealFeel© of each observation, in ºC
+ * @param count Number of observations
+ */
+void calculate_real_feels (const float* temperature, const float* humidity, const float* wind_speed,
+                           const float* pressure, const float* uv_index, float* dew_point, float* real_feel,
+                           size_t count)
+{
+    size_t f = 0;
+
+#if defined(__SSE2__)
+    vfloat zero = vf_set(0);
+
+    for (; f + VF_LANES <= count; f += VF_LANES) {
+        vfloat temp = vf_load(temperature + f);
+        vfloat hum = vf_load(humidity + f);
+        vfloat skip = vf_and(vf_eq(temp, zero), vf_eq(hum, zero));
+        vfloat dew = vf_dew_point(temp, hum);
+        vfloat feel = vf_real_feel(temp, dew, vf_load(wind_speed + f), vf_load(pressure + f), vf_round_uv(vf_load(uv_index + f)));
+
+        vf_store(dew_point + f, vf_select(skip, vf_load(dew_point + f), dew));
+        vf_store(real_feel + f, vf_select(skip, vf_load(real_feel + f), feel));
+    }
+#endif
+
+    for (; f < count; f++) {
+        if (temperature[f] == 0 && humidity[f] == 0)
+            continue;
+        dew_point[f] = batch_dew_point(temperature[f], humidity[f]);
+        real_feel[f] = real_feel_kernel(temperature[f], dew_point[f], wind_speed[f], pressure[f], lround(uv_index[f]));
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file derived_values.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Library to calculate the values derived from an observation
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Kernels of the calculations of Observation and ObservationBatch, without
+ * pow(). The humidity of the station is an integer from 0 to 99, so the root
+ * of the dew point formula is read from a table built with the original
+ * pow() expression, which gives the same bits. Any other humidity uses three
+ * chained square roots, within DEW_POINT_ROOT_TOLERANCE of pow().
+ *
+ * The RealFeel© kernel has no branches: both ways of the patent formula are
+ * calculated with the square roots they share and the result is selected,
+ * and the clamps of the wind speed and the dew point are min/max. The batch
+ * kernels run it 4 (SSE2) or 8 (AVX) observations at a time on x86, with
+ * the dew point calculated in single precision, which differs from the
+ * table by rounding (at most BATCH_DEW_POINT_TOLERANCE and
+ * BATCH_REAL_FEEL_TOLERANCE times the value, or times 1 for the values
+ * between -1 and 1).
+ */
+
+#ifndef DERIVED_VALUES_H
+#define DERIVED_VALUES_H
+
+#include <cstddef>
+
+/// Number of humidities (0 to 99 %) with the dew point root in the table.
+const int DEW_POINT_TABLE_SIZE = 100;
+/// Largest relative difference of dew_point_root() with pow() out of the table.
+const double DEW_POINT_ROOT_TOLERANCE = 1e-7;
+/// Largest relative difference of calculate_dew_points() with calculate_dew_point().
+const float BATCH_DEW_POINT_TOLERANCE = 1e-4;
+/// Largest relative difference of calculate_real_feels() with calculate_real_feel().
+const float BATCH_REAL_FEEL_TOLERANCE = 1e-4;
+
+float dew_point_root (float humidity);
+float calculate_dew_point (float temperature, float humidity);
+float calculate_real_feel (float temperature, float dew_point, float wind_speed, float pressure, int uv_index);
+
+void calculate_dew_points (const float* temperature, const float* humidity, float* dew_point, size_t count);
+void calculate_real_feels (const float* temperature, const float* humidity, const float* wind_speed,
+                           const float* pressure, const float* uv_index, float* dew_point, float* real_feel,
+                           size_t count);
+
+#endif
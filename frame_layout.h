@@ -0,0 +1,54 @@
+/**
+ * @file frame_layout.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Layouts of the frames of the supported stations
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Each layout is a type with the position of every field in the frame of the
+ * current readings of a station model, and the scale of the fields that
+ * depend on the model. The frame decoder is a template on the
+ * layout, so each model gets its own decoder with the positions as constants,
+ * and a new model only needs a new layout.
+ */
+
+#ifndef FRAME_LAYOUT_H
+#define FRAME_LAYOUT_H
+
+/**
+ * @brief Layout of the TE923 frame
+ *
+ * Also used by the compatible stations (Hideki TE923, Mebus TE923, ...).
+ */
+struct TE923Layout {
+    /// Number of temperature and humidity channels (0 is the indoor one).
+    static const int SENSORS = 6;
+    /// Distance between the fields of two consecutive sensors.
+    static const int SENSOR_STRIDE = 3;
+    /// Temperature of the first sensor (tenths and units, then flags and tens).
+    static const int TEMPERATURE = 0;
+    /// Humidity of the first sensor.
+    static const int HUMIDITY = 2;
+    /// UV index (tenths and units, then tens).
+    static const int UV = 18;
+    /// Pressure (low and high bytes, in 1/16 mb).
+    static const int PRESSURE = 20;
+    /// Wind chill (tenths and units, then flags and tens).
+    static const int WIND_CHILL = 23;
+    /// Wind gust (tenths and units, then flags and tens, in mph).
+    static const int WIND_GUST = 25;
+    /// Wind speed (tenths and units, then flags and tens, in mph).
+    static const int WIND_SPEED = 27;
+    /// Wind direction (low nibble, in steps of 22.5º).
+    static const int WIND_DIR = 29;
+    /// Rain counter (low and high bytes, in tips of the bucket).
+    static const int RAIN = 30;
+    /// Rain of each tip of the bucket, in mm.
+    static constexpr double RAIN_MM_PER_TIP = 0.6578;
+    /// XOR CRC of the previous bytes.
+    static const int CRC = 33;
+};
+
+#endif
@@ -0,0 +1,630 @@
+/**
+ * @file fuzz.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Differential fuzzer of the frame decoders
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Feeds arbitrary frames through the per-field decoders, decode_frame() and
+ * the batch decoder (SIMD and scalar), and aborts if any value or status
+ * differs between them, if a value, a valid flag or the CRC check differs
+ * from a frozen copy of the original decoders, if the Observation of a
+ * frame changes when it is packed in a PackedObservation and unpacked, or
+ * if the dew point and the RealFeel© of an ObservationBatch are not those
+ * of Observation (within the tolerances of the batch kernels), or if the
+ * dew point of derived_values.h is not the one of the original pow()
+ * formula. Every frame is copied to a buffer of exactly BUFLEN bytes, so a
+ * build with -fsanitize=address catches any read out of the frame.
+ *
+ * Built with "make fuzz" as a standalone program, which checks the frames
+ * of the given frame logs and then random frames and mutations of them:
+ *
+ *   WS3_fuzz [--iterations <n>] [--seed <n>] [frame logs...]
+ *
+ * Built with "make fuzz-libfuzzer" (clang) it is a libFuzzer target, where
+ * each input is a batch of frames of BUFLEN bytes.
+ */
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "batch_decoder.h"
+#include "data_decoder.h"
+#include "derived_values.h"
+#include "FrameLog.h"
+#include "Observation.h"
+#include "ObservationBatch.h"
+#include "PackedObservation.h"
+
+using namespace std;
+
+/// Largest batch of frames decoded at once.
+const size_t FUZZ_MAX_BATCH = 64;
+
+/// Bytes with a meaning for the decoders, used more often in random frames.
+const uint8_t FUZZ_SPECIAL_BYTES[] = {
+    0x00, 0x09, 0x0A, 0x0B, 0x0C, 0x40, 0x4B, 0x80, 0x8A, 0x8B, 0x8E,
+    0x90, 0x99, 0x9A, 0xA9, 0xAA, 0xBB, 0xEE, 0xF0, 0xFF
+};
+
+/**
+ * @brief Abort showing the frame where the decoders differ
+ *
+ * @param frame Frame decoded
+ * @param what Value that differs
+ */
+static void fuzz_fail(const uint8_t* frame, const char* what)
+{
+    fprintf(stderr, "Decoders differ in %s for the frame:", what);
+    for (int i = 0; i < BUFLEN; i++)
+        fprintf(stderr, " %02x", frame[i]);
+    fprintf(stderr, "\n");
+    abort();
+}
+
+/**
+ * @brief Check that two floats have the same bits
+ *
+ * @param frame Frame decoded
+ * @param what Name of the value
+ * @param expected Value of decode_frame()
+ * @param value Value of the other decoder
+ */
+static void check_value(const uint8_t* frame, const char* what, float expected, float value)
+{
+    if (memcmp(&expected, &value, sizeof(float)) != 0)
+        fuzz_fail(frame, what);
+}
+
+/*
+ * Frozen copy of the arithmetic of the original decoders (the per-field
+ * decode_* functions of 2019, without their output, extended to every
+ * channel, plus the UV index and rain decoders as first written). It does not
+ * share bcd_table.h nor the status helpers with data_decoder.cpp, so it
+ * catches a regression in them. Do not change it with the decoders.
+ */
+
+/**
+ * @brief Original transformation of a BCD character to an integer
+ *
+ * @param bcd Character to transform
+ * @return int Integer representation of the character
+ */
+static int oracle_bcd2int(char bcd)
+{
+    return ((int)((bcd & 0xF0) >> 4) * 10 + (int)(bcd & 0x0F));
+}
+
+/**
+ * @brief Original error check of the wind bytes
+ *
+ * @param raw_data Frame decoded
+ * @param offset Position of the value
+ * @return int 0 if the value is available, negative otherwise
+ */
+static int oracle_wind_error(const uint8_t* raw_data, int offset)
+{
+    int data_err = 0;
+
+    if ((oracle_bcd2int(raw_data[offset] & 0xF0) > 90) || (oracle_bcd2int(raw_data[offset] & 0x0F) > 9)) {
+        if ((raw_data[offset] == 0xBB) && (raw_data[offset + 1] == 0x8B))
+            data_err = -2;
+        else if ((raw_data[offset] == 0xEE) && (raw_data[offset + 1] == 0x8E))
+            data_err = -3;
+        else
+            data_err = -4;
+    }
+    return data_err;
+}
+
+/**
+ * @brief Decode a frame with the original arithmetic
+ *
+ * @param raw_data Frame decoded
+ * @return DecodedFrame Values and valid flags (the statuses are not set)
+ */
+static DecodedFrame oracle_decode(const uint8_t* raw_data)
+{
+    DecodedFrame decoded;
+    int data_err;
+    int offset;
+    float tmp_data;
+
+    memset(&decoded, 0, sizeof(decoded));
+
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        offset = i * 3;
+        data_err = 0;
+        tmp_data = 0.0;
+
+        if (oracle_bcd2int(raw_data[offset] & 0x0F) > 9) {
+            if (((raw_data[offset] & 0x0F) == 0x0C) || ((raw_data[offset] & 0x0F) == 0x0B))
+                data_err = -2;
+            else
+                data_err = -1;
+        }
+        if (((raw_data[1 + offset] & 0x40) != 0x40) && i > 0)
+            data_err = -2;
+
+        if (!data_err) {
+            tmp_data = (oracle_bcd2int(raw_data[offset]) / 10.0) + (oracle_bcd2int(raw_data[1 + offset] & 0x0F) * 10.0);
+            if ((raw_data[1 + offset] & 0x20) == 0x20)
+                tmp_data += 0.05;
+            if ((raw_data[1 + offset] & 0x80) != 0x80)
+                tmp_data *= -1;
+            decoded.valid |= DECODED_TEMPERATURE << i;
+        }
+        decoded.temperature[i] = tmp_data;
+
+        if (data_err > -2 && oracle_bcd2int(raw_data[2 + offset] & 0x0F) <= 9) {
+            decoded.humidity[i] = oracle_bcd2int(raw_data[2 + offset]);
+            decoded.valid |= DECODED_HUMIDITY << i;
+        }
+    }
+
+    if ((raw_data[21] & 0xF0) != 0xF0) {
+        decoded.pressure = static_cast<int>(raw_data[21] * 0x100 + raw_data[20]) * 0.0625;
+        decoded.valid |= DECODED_PRESSURE;
+    }
+
+    data_err = oracle_wind_error(raw_data, 23);
+    if ((raw_data[24] & 0x40) != 0x40)
+        data_err = -2;
+    if (data_err == 0) {
+        tmp_data = (oracle_bcd2int(raw_data[23]) / 10.0) + (oracle_bcd2int(raw_data[24] & 0x0F) * 10.0);
+        if ((raw_data[24] & 0x20) == 0x20)
+            tmp_data += 0.05;
+        if ((raw_data[24] & 0x80) != 0x80)
+            tmp_data *= -1;
+        decoded.wind_chill = tmp_data;
+        decoded.valid |= DECODED_WIND_CHILL;
+    }
+
+    tmp_data = 0.0;
+    if (oracle_wind_error(raw_data, 25) == 0) {
+        tmp_data = ((oracle_bcd2int(raw_data[25]) / 10.0) + (oracle_bcd2int(raw_data[26] & 0x0F) * 10.0) +
+                    ((raw_data[26] & 0x10) == 0x10 ? 100 : 0)) / 2.23694;
+        decoded.valid |= DECODED_WIND_GUST;
+    }
+    decoded.wind_gust = tmp_data * 3.6;
+
+    tmp_data = 0.0;
+    if (oracle_wind_error(raw_data, 27) == 0) {
+        tmp_data = ((oracle_bcd2int(raw_data[27]) / 10.0) + (oracle_bcd2int(raw_data[28] & 0x0F) * 10.0) +
+                    ((raw_data[28] & 0x10) == 0x10 ? 100 : 0)) / 2.23694;
+        decoded.valid |= DECODED_WIND_SPEED;
+    }
+    decoded.wind_speed = tmp_data * 3.6;
+
+    if (oracle_wind_error(raw_data, 25) > -3 && oracle_wind_error(raw_data, 27) > -3) {
+        decoded.wind_dir = ((int)raw_data[29] & 0x0F) * 22.5;
+        decoded.valid |= DECODED_WIND_DIR;
+    }
+
+    if ((raw_data[18] & 0x0F) <= 9 && oracle_bcd2int(raw_data[18] & 0xF0) <= 90 && (raw_data[19] & 0x0F) <= 9) {
+        decoded.uv = (oracle_bcd2int(raw_data[18]) / 10.0) + ((raw_data[19] & 0x0F) * 10.0);
+        decoded.valid |= DECODED_UV;
+    }
+
+    decoded.rain = (raw_data[31] * 0x100 + raw_data[30]) * 0.6578;
+    decoded.valid |= DECODED_RAIN;
+
+    return decoded;
+}
+
+/**
+ * @brief Check a frame against the original decoders and CRC
+ *
+ * @param frame Frame decoded
+ * @param decoded Values of decode_frame()
+ */
+static void check_oracle(const uint8_t* frame, const DecodedFrame& decoded)
+{
+    DecodedFrame expected = oracle_decode(frame);
+    unsigned char crc = 0x00;
+
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        check_value(frame, "original temperature", expected.temperature[i], decoded.temperature[i]);
+        check_value(frame, "original humidity", expected.humidity[i], decoded.humidity[i]);
+    }
+    check_value(frame, "original pressure", expected.pressure, decoded.pressure);
+    check_value(frame, "original wind chill", expected.wind_chill, decoded.wind_chill);
+    check_value(frame, "original wind gust", expected.wind_gust, decoded.wind_gust);
+    check_value(frame, "original wind speed", expected.wind_speed, decoded.wind_speed);
+    check_value(frame, "original wind dir", expected.wind_dir, decoded.wind_dir);
+    check_value(frame, "original uv", expected.uv, decoded.uv);
+    check_value(frame, "original rain", expected.rain, decoded.rain);
+    if (expected.valid != decoded.valid)
+        fuzz_fail(frame, "original valid flags");
+
+    for (int i = 0; i <= 32; i++)
+        crc = crc ^ frame[i];
+    if (check_crc(const_cast<uint8_t*>(frame)) != (crc == frame[33] || crc == 0x5a))
+        fuzz_fail(frame, "check_crc");
+}
+
+/**
+ * @brief Fill an Observation with the values of a frame
+ *
+ * The Observation is cleared and filled as process_frame() does, with the
+ * UV index of the API if the station has no UV sensor, but the derived
+ * values are not calculated.
+ *
+ * @param frame Frame decoded
+ * @param decoded Values of decode_frame()
+ * @param obs Observation to fill
+ */
+static void fill_observation(const uint8_t* frame, const DecodedFrame& decoded, Observation& obs)
+{
+    obs.clear(frame[0] * 0x01000001u);
+    obs.setValidFields(decoded.valid);
+    obs.setFieldStatus(decoded.status);
+    obs.setPressure(decoded.pressure);
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        obs.setTemperature(decoded.temperature[i], i);
+        obs.setHumidity(decoded.humidity[i], i);
+    }
+    obs.setWindChill(decoded.wind_chill);
+    obs.setWindGust(decoded.wind_gust);
+    obs.setWindSpeed(decoded.wind_speed);
+    obs.setWindDir(decoded.wind_dir);
+    obs.setRainfall(decoded.rain);
+    obs.setUVIndex((decoded.valid & DECODED_UV) != 0 ? decoded.uv : frame[1] % 12);
+}
+
+/**
+ * @brief Check that an Observation of a frame survives a PackedObservation
+ *
+ * @param frame Frame decoded
+ * @param decoded Values of decode_frame()
+ */
+static void check_packed(const uint8_t* frame, const DecodedFrame& decoded)
+{
+    Observation obs, unpacked;
+    PackedObservation packed;
+
+    fill_observation(frame, decoded, obs);
+    obs.calculateDewPoint();
+    obs.calculateRealFeel(lround(obs.getUVIndex()));
+
+    packed.pack(obs);
+    packed.unpack(unpacked);
+
+    if (unpacked.getTimestamp() != obs.getTimestamp())
+        fuzz_fail(frame, "packed timestamp");
+    if (unpacked.getValidFields() != obs.getValidFields())
+        fuzz_fail(frame, "packed valid flags");
+    if (unpacked.getFieldStatus() != obs.getFieldStatus())
+        fuzz_fail(frame, "packed status");
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        check_value(frame, "packed temperature", obs.getTemperature(i), unpacked.getTemperature(i));
+        check_value(frame, "packed humidity", obs.getHumidity(i), unpacked.getHumidity(i));
+    }
+    check_value(frame, "packed pressure", obs.getPressure(), unpacked.getPressure());
+    check_value(frame, "packed wind chill", obs.getWindChill(), unpacked.getWindChill());
+    check_value(frame, "packed wind gust", obs.getWindGust(), unpacked.getWindGust());
+    check_value(frame, "packed wind speed", obs.getWindSpeed(), unpacked.getWindSpeed());
+    check_value(frame, "packed wind dir", obs.getWindDir(), unpacked.getWindDir());
+    check_value(frame, "packed rain", obs.getRainfall(), unpacked.getRainfall());
+    check_value(frame, "packed uv", obs.getUVIndex(), unpacked.getUVIndex());
+    check_value(frame, "packed dew point", obs.getDewPoint(), unpacked.getDewPoint());
+    check_value(frame, "packed real feel", obs.getRealFeel(), unpacked.getRealFeel());
+}
+
+/**
+ * @brief Check that two floats differ less than a tolerance
+ *
+ * @param frame Frame decoded
+ * @param what Name of the value
+ * @param expected Value of Observation
+ * @param value Value of ObservationBatch
+ * @param tolerance Largest relative difference allowed (absolute below 1)
+ */
+static void check_close(const uint8_t* frame, const char* what, float expected, float value, float tolerance)
+{
+    if (isnan(expected) && isnan(value))
+        return;
+    if (expected != value && !(fabs(expected - value) <= tolerance * fmax(1.0, fabs(expected))))
+        fuzz_fail(frame, what);
+}
+
+/**
+ * @brief Check the dew point kernel against the original formula
+ *
+ * The integer humidities of the frame have to give the same bits, and the
+ * same humidities with a fraction (taken from the frame) the same value
+ * within DEW_POINT_ROOT_TOLERANCE.
+ *
+ * @param frame Frame decoded
+ * @param decoded Values of decode_frame()
+ */
+static void check_dew_point(const uint8_t* frame, const DecodedFrame& decoded)
+{
+    float humidity, expected, root;
+
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+        humidity = decoded.humidity[i];
+        expected = pow(humidity / 100, 0.125);
+        expected *= (112 + (0.9 * decoded.temperature[i]));
+        expected -= 112;
+        check_value(frame, "dew point", expected, calculate_dew_point(decoded.temperature[i], humidity));
+
+        humidity += frame[i] / 256.0f;
+        expected = pow(humidity / 100, 0.125);
+        root = dew_point_root(humidity);
+        if (expected != root && !(fabs(expected - root) <= DEW_POINT_ROOT_TOLERANCE * expected))
+            fuzz_fail(frame, "dew point root");
+    }
+}
+
+/**
+ * @brief Check the derived values of ObservationBatch against Observation
+ *
+ * @param frames Frames decoded
+ * @param expected Values of decode_frame() of each frame
+ */
+static void check_observation_batch(const RawFrame* frames, const vector<DecodedFrame>& expected)
+{
+    vector<Observation> observations(expected.size());
+    ObservationBatch dew_points, real_feels;
+    Observation copy;
+
+    for (size_t f = 0; f < expected.size(); f++) {
+        fill_observation(frames[f], expected[f], observations[f]);
+        dew_points.push_back(observations[f]);
+        real_feels.push_back(observations[f]);
+        observations[f].calculateRealFeel(lround(observations[f].getUVIndex()));
+    }
+    dew_points.calculateDewPoint();
+    real_feels.calculateRealFeel();
+
+    for (size_t f = 0; f < expected.size(); f++) {
+        copy.setFieldStatus(~(uint64_t)0);
+        dew_points.getObservation(f, copy);
+        if (copy.getValidFields() != observations[f].getValidFields())
+            fuzz_fail(frames[f], "batch valid flags");
+        if (copy.getFieldStatus() != observations[f].getFieldStatus())
+            fuzz_fail(frames[f], "batch status");
+        check_close(frames[f], "batch dew point", observations[f].getDewPoint(), dew_points.getDewPoints()[f],
+                    BATCH_DEW_POINT_TOLERANCE);
+        check_close(frames[f], "batch real feel dew point", observations[f].getDewPoint(), real_feels.getDewPoints()[f],
+                    BATCH_DEW_POINT_TOLERANCE);
+        check_close(frames[f], "batch real feel", observations[f].getRealFeel(), real_feels.getRealFeels()[f],
+                    BATCH_REAL_FEEL_TOLERANCE);
+    }
+}
+
+/**
+ * @brief Check the per-field decoders and the statuses of a frame
+ *
+ * @param frame Frame of exactly BUFLEN bytes
+ * @param decoded Values of decode_frame()
+ */
+static void check_fields(uint8_t* frame, const DecodedFrame& decoded)
+{
+    array<float, TE923_FRAME_SENSORS> values;
+    list<float> value_list;
+    float partial[TE923_FRAME_SENSORS];
+    int i;
+
+    decode_temperature(frame, values);
+    value_list = decode_temperature(frame);
+    i = 0;
+    for (float value : value_list) {
+        check_value(frame, "temperature", decoded.temperature[i], values[i]);
+        check_value(frame, "temperature list", decoded.temperature[i], value);
+        i++;
+    }
+    if (decode_temperature(frame, partial, 1) != 1)
+        fuzz_fail(frame, "temperature count");
+    check_value(frame, "temperature buffer", decoded.temperature[0], partial[0]);
+
+    decode_humidity(frame, values);
+    value_list = decode_humidity(frame);
+    i = 0;
+    for (float value : value_list) {
+        check_value(frame, "humidity", decoded.humidity[i], values[i]);
+        check_value(frame, "humidity list", decoded.humidity[i], value);
+        i++;
+    }
+    if (decode_humidity(frame, partial, TE923_FRAME_SENSORS + 1) != TE923_FRAME_SENSORS)
+        fuzz_fail(frame, "humidity count");
+
+    check_value(frame, "pressure", decoded.pressure, decode_pressure(frame));
+    check_value(frame, "wind chill", decoded.wind_chill, decode_wind_chill(frame));
+    check_value(frame, "wind gust", decoded.wind_gust, decode_wind_gust(frame));
+    check_value(frame, "wind speed", decoded.wind_speed, decode_wind_speed(frame));
+    check_value(frame, "wind dir", decoded.wind_dir, decode_wind_dir(frame));
+    check_value(frame, "uv", decoded.uv, decode_uv(frame));
+    check_value(frame, "rain", decoded.rain, decode_rain(frame));
+
+    if ((decoded.valid & ~DECODED_ALL) != 0)
+        fuzz_fail(frame, "valid flags");
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (((decoded.valid >> field) & 1) != (get_field_status(decoded, field) == STATUS_OK ? 1u : 0u))
+            fuzz_fail(frame, "status");
+        if (get_field_status(decoded, field) >= STATUS_COUNT)
+            fuzz_fail(frame, "status range");
+    }
+    if (decode_frame_status(*(const RawFrame*)frame) != decoded.status)
+        fuzz_fail(frame, "decode_frame_status");
+
+    check_oracle(frame, decoded);
+    check_packed(frame, decoded);
+    check_dew_point(frame, decoded);
+}
+
+/**
+ * @brief Decode a batch of frames with every decoder and compare them
+ *
+ * @param data Frames, BUFLEN bytes each
+ * @param count Number of frames (at most FUZZ_MAX_BATCH)
+ */
+static void fuzz_batch(const uint8_t* data, size_t count)
+{
+    RawFrame *frames = new RawFrame[count];
+    vector<DecodedFrame> expected(count);
+    vector<float> values[2][2 * TE923_FRAME_SENSORS + 7];
+    vector<uint32_t> valid[2];
+    vector<uint64_t> status[2];
+    DecodedColumns columns[2];
+    uint8_t *frame;
+    int v;
+
+    memcpy(frames, data, count * BUFLEN);
+
+    for (size_t f = 0; f < count; f++) {
+        /* Exactly BUFLEN bytes, so the sanitizer sees any read out of it */
+        frame = new uint8_t[BUFLEN];
+        memcpy(frame, frames[f], BUFLEN);
+        expected[f] = decode_frame(*(const RawFrame*)frame);
+        check_fields(frame, expected[f]);
+        delete[] frame;
+    }
+
+    for (int c = 0; c < 2; c++) {
+        v = 0;
+        for (auto& column : values[c])
+            column.resize(count);
+        valid[c].resize(count);
+        status[c].resize(count);
+        for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+            columns[c].temperature[i] = values[c][v++].data();
+            columns[c].humidity[i] = values[c][v++].data();
+        }
+        columns[c].pressure = values[c][v++].data();
+        columns[c].wind_chill = values[c][v++].data();
+        columns[c].wind_gust = values[c][v++].data();
+        columns[c].wind_speed = values[c][v++].data();
+        columns[c].wind_dir = values[c][v++].data();
+        columns[c].uv = values[c][v++].data();
+        columns[c].rain = values[c][v++].data();
+        columns[c].valid = valid[c].data();
+        columns[c].status = status[c].data();
+    }
+    decode_frames(frames, count, columns[0]);
+    decode_frames_scalar(frames, count, columns[1]);
+
+    for (int c = 0; c < 2; c++) {
+        for (size_t f = 0; f < count; f++) {
+            for (int i = 0; i < TE923_FRAME_SENSORS; i++) {
+                check_value(frames[f], "batch temperature", expected[f].temperature[i], columns[c].temperature[i][f]);
+                check_value(frames[f], "batch humidity", expected[f].humidity[i], columns[c].humidity[i][f]);
+            }
+            check_value(frames[f], "batch pressure", expected[f].pressure, columns[c].pressure[f]);
+            check_value(frames[f], "batch wind chill", expected[f].wind_chill, columns[c].wind_chill[f]);
+            check_value(frames[f], "batch wind gust", expected[f].wind_gust, columns[c].wind_gust[f]);
+            check_value(frames[f], "batch wind speed", expected[f].wind_speed, columns[c].wind_speed[f]);
+            check_value(frames[f], "batch wind dir", expected[f].wind_dir, columns[c].wind_dir[f]);
+            check_value(frames[f], "batch uv", expected[f].uv, columns[c].uv[f]);
+            check_value(frames[f], "batch rain", expected[f].rain, columns[c].rain[f]);
+            if (columns[c].valid[f] != expected[f].valid)
+                fuzz_fail(frames[f], "batch valid flags");
+            if (columns[c].status[f] != expected[f].status)
+                fuzz_fail(frames[f], "batch status");
+        }
+    }
+
+    check_observation_batch(frames, expected);
+
+    delete[] frames;
+}
+
+#ifdef WS3_LIBFUZZER
+
+/**
+ * @brief Entry point of libFuzzer
+ *
+ * The input is split in frames of BUFLEN bytes, ignoring the last partial
+ * one, and decoded as a batch.
+ *
+ * @param data Input of the fuzzer
+ * @param size Size of the input
+ * @return int Always 0
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    size_t count = size / BUFLEN;
+
+    if (count > FUZZ_MAX_BATCH)
+        count = FUZZ_MAX_BATCH;
+    if (count > 0)
+        fuzz_batch(data, count);
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    long iterations = 100000;
+    unsigned int seed = 1;
+    vector<uint8_t> corpus;
+    vector<uint8_t> batch;
+    FrameLog log;
+    FrameLogRecord record;
+    size_t corpus_frames, count;
+    mt19937 generator;
+    uniform_int_distribution<int> byte(0, 255);
+    uniform_int_distribution<int> special(0, sizeof(FUZZ_SPECIAL_BYTES) - 1);
+    uniform_int_distribution<int> kind(0, 3);
+    uniform_int_distribution<int> position(0, BUFLEN - 1);
+    uniform_int_distribution<size_t> batch_size(1, FUZZ_MAX_BATCH);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [--iterations <n>] [--seed <n>] [frame logs...]\n", argv[0]);
+            return 1;
+        } else {
+            if (log.openRead(argv[i]) < 0)
+                return 1;
+            while (log.next(record) == 0)
+                corpus.insert(corpus.end(), record.frame, record.frame + BUFLEN);
+        }
+    }
+    generator.seed(seed);
+
+    /* The frames of the logs as they are */
+    corpus_frames = corpus.size() / BUFLEN;
+    for (size_t f = 0; f < corpus_frames; f += FUZZ_MAX_BATCH)
+        fuzz_batch(corpus.data() + f * BUFLEN, min(FUZZ_MAX_BATCH, corpus_frames - f));
+
+    /* Random frames, or frames of the logs with some bytes replaced */
+    for (long n = 0; n < iterations; n++) {
+        count = batch_size(generator);
+        batch.resize(count * BUFLEN);
+        for (size_t f = 0; f < count; f++) {
+            uint8_t *frame = batch.data() + f * BUFLEN;
+
+            if (corpus_frames > 0 && kind(generator) != 0) {
+                memcpy(frame, corpus.data() + (generator() % corpus_frames) * BUFLEN, BUFLEN);
+                for (int m = kind(generator); m >= 0; m--)
+                    frame[position(generator)] = kind(generator) == 0 ? byte(generator) : FUZZ_SPECIAL_BYTES[special(generator)];
+            } else {
+                for (int i = 0; i < BUFLEN; i++)
+                    frame[i] = kind(generator) == 0 ? FUZZ_SPECIAL_BYTES[special(generator)] : byte(generator);
+            }
+        }
+        fuzz_batch(batch.data(), count);
+    }
+
+    printf("%zu frames of the logs and %ld random batches decoded, no differences\n", corpus_frames, iterations);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file line_protocol.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Formatting of the Observations for the DB
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Formats an Observation as a point of the InfluxDB line protocol, as stored
+ * by write_into_DB().
+ */
+
+#include "line_protocol.h"
+
+using namespace std;
+
+/**
+ * @brief Function to write a tag value escaped for the line protocol
+ * 
+ * Commas, spaces and equal signs would end the tag, so they are escaped
+ * with a backslash, and so are the backslashes themselves.
+ * 
+ * @param out Stream where the value is written
+ * @param value Value of the tag
+ */
+static void format_tag_value (std::ostream& out, const std::string& value)
+{
+    for (char c : value) {
+        if (c == ',' || c == ' ' || c == '=' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+}
+
+/**
+ * @brief Function to format an Observation as a line protocol point
+ * 
+ * The point is the measurement "observation", tagged with the station when
+ * it is known (escaped as the line protocol requires), with the
+ * comma-separated pairs of sensor=value and the timestamp of the
+ * Observation (in seconds).
+ * 
+ * More info at https://docs.influxdata.com/influxdb/v1.8/write_protocols/line_protocol_reference/
+ * 
+ * @param out Stream where the point is written
+ * @param obs Observation to format
+ */
+void format_line_protocol (std::ostream& out, const Observation& obs)
+{
+    out << "observation";
+    if (!obs.getStationId().empty())
+    {
+        out << ",station=";
+        format_tag_value(out, obs.getStationId());
+    }
+    out << " temp=" << obs.getTemperature(1) << ",humid=" << obs.getHumidity(1) << "i,press=" << obs.getPressure() \
+    << ",wind_dir=" << obs.getWindDir() << ",wind_spd=" << obs.getWindSpeed() << ",wind_gst=" << obs.getWindGust() << ",rain=" \
+    << obs.getRainfall() << ",uv=" << obs.getUVIndex() << ",rfel=" << obs.getRealFeel() << " " << obs.getTimestamp();
+}
@@ -0,0 +1,23 @@
+/**
+ * @file line_protocol.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Formatting of the Observations for the DB
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Formats an Observation as a point of the InfluxDB line protocol, as stored
+ * by write_into_DB().
+ */
+
+#ifndef LINE_PROTOCOL_H
+#define LINE_PROTOCOL_H
+
+#include <ostream>
+
+#include "Observation.h"
+
+void format_line_protocol (std::ostream& out, const Observation& obs);
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file logger.cpp
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Logging facade with the levels fixed at compile time
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * Output of the LOG_* macros. Nothing is allocated: each message is
+ * formatted in a buffer of the thread and copied to a shared buffer, so the
+ * lock is only held for the copy and stderr is only written when the shared
+ * buffer is full, after an error or when the log is flushed.
+ */
+
+#include "logger.h"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+
+/// Longest message, longer ones are truncated.
+const size_t LOG_LINE_SIZE = 512;
+/// Size of the buffer shared by every thread.
+const size_t LOG_BUFFER_SIZE = 64 * 1024;
+
+/// Prefix of the messages of each level.
+static const char* const LOG_PREFIXES[] = {
+    "[ERROR] ", "[WARNING] ", "[INFO] ", "[DEBUG] "
+};
+
+/// Messages not written yet.
+static char log_buffer[LOG_BUFFER_SIZE];
+/// Bytes used of log_buffer.
+static size_t log_used = 0;
+/// Lock of log_buffer.
+static std::mutex log_mutex;
+
+/**
+ * @brief Write the shared buffer to stderr and empty it
+ *
+ * Called with log_mutex held.
+ */
+static void flush_buffer()
+{
+    size_t written = 0;
+    ssize_t result;
+
+    while (written < log_used) {
+        result = write(STDERR_FILENO, log_buffer + written, log_used - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            break;
+        written += result;
+    }
+    log_used = 0;
+}
+
+/**
+ * @brief Flush the messages left when the program ends
+ */
+static struct LogFinalFlush {
+    ~LogFinalFlush() { log_flush(); }
+} log_final_flush;
+
+/**
+ * @brief Function to write a message of the log
+ *
+ * Used through the LOG_* macros, which remove the disabled levels.
+ *
+ * @param level WS3_LOG_* level of the message
+ * @param format printf format of the message, without the final newline
+ */
+void log_write (int level, const char* format, ...)
+{
+    static thread_local char line[LOG_LINE_SIZE];
+    size_t length;
+    int result;
+    va_list args;
+
+    if (level < WS3_LOG_ERROR || level > WS3_LOG_DEBUG)
+        level = WS3_LOG_ERROR;
+
+    length = strlen(LOG_PREFIXES[level]);
+    memcpy(line, LOG_PREFIXES[level], length);
+
+    va_start(args, format);
+    result = vsnprintf(line + length, LOG_LINE_SIZE - length - 1, format, args);
+    va_end(args);
+
+    if (result > 0)
+        length += (size_t)result < LOG_LINE_SIZE - length - 1 ? (size_t)result : LOG_LINE_SIZE - length - 2;
+    line[length++] = '\n';
+
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (log_used + length > LOG_BUFFER_SIZE)
+        flush_buffer();
+    memcpy(log_buffer + log_used, line, length);
+    log_used += length;
+    /* The errors and the warnings keep their order with the rest of stderr */
+    if (level <= WS3_LOG_WARNING)
+        flush_buffer();
+}
+
+/**
+ * @brief Function to write the pending messages of the log to stderr
+ */
+void log_flush ()
+{
+    std::lock_guard<std::mutex> lock(log_mutex);
+
+    flush_buffer();
+}
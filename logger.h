@@ -0,0 +1,68 @@
+/**
+ * @file logger.h
+ * @author Josep Dols (jodoldar@gmail.com)
+ * @brief Logging facade with the levels fixed at compile time
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2019
+ *
+ * The messages are written with the LOG_* macros, using the printf syntax.
+ * The levels above WS3_LOG_LEVEL are removed by the preprocessor, so they
+ * cost nothing, not even the evaluation of their arguments. The enabled ones
+ * are formatted into a buffer preallocated per thread and appended to a
+ * shared buffer, which is written to stderr when it is full, after each
+ * error or warning and with log_flush().
+ *
+ * WS3_LOG_LEVEL can be defined for each build (-D WS3_LOG_LEVEL=2), else it
+ * is WS3_LOG_DEBUG in the DEBUG builds and WS3_LOG_WARNING otherwise.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/// Errors, written to stderr at once.
+#define WS3_LOG_ERROR 0
+/// Unexpected situations the program recovers from, also written at once.
+#define WS3_LOG_WARNING 1
+/// Progress of the program.
+#define WS3_LOG_INFO 2
+/// Details to follow the decoding of the frames.
+#define WS3_LOG_DEBUG 3
+
+#ifndef WS3_LOG_LEVEL
+#ifdef DEBUG
+#define WS3_LOG_LEVEL WS3_LOG_DEBUG
+#else
+#define WS3_LOG_LEVEL WS3_LOG_WARNING
+#endif
+#endif
+
+void log_write (int level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+void log_flush ();
+
+#if WS3_LOG_LEVEL >= WS3_LOG_ERROR
+#define LOG_ERROR(...) log_write(WS3_LOG_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do { } while (0)
+#endif
+
+#if WS3_LOG_LEVEL >= WS3_LOG_WARNING
+#define LOG_WARNING(...) log_write(WS3_LOG_WARNING, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) do { } while (0)
+#endif
+
+#if WS3_LOG_LEVEL >= WS3_LOG_INFO
+#define LOG_INFO(...) log_write(WS3_LOG_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do { } while (0)
+#endif
+
+#if WS3_LOG_LEVEL >= WS3_LOG_DEBUG
+#define LOG_DEBUG(...) log_write(WS3_LOG_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do { } while (0)
+#endif
+
+#endif
@@ -19,135 +19,484 @@
  *  - Implement the DB call in order to save the retrieved data.
  */
 
+#include <atomic>
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <cmath>
+#include <csignal>
+#include <map>
+#include <mutex>
+#include <cstdlib>
 #include <cstring>
 #include <libusb-1.0/libusb.h>
 
 #include "data_decoder.h"
 #include "main.h"
 #include "network_utils.hpp"
+#include "DeviceManager.h"
+#include "FramePool.h"
+#include "HistoryReader.h"
+#include "line_protocol.h"
+#include "ObservationWriter.h"
+#include "ReplayFrameSource.h"
+#include "SimulatedFrameSource.h"
+#include "UsbTracer.h"
+#include "logger.h"
 //#include "Observation.h"
 
 using namespace std;
 
+/**
+ * @brief UV index shared by all the stations, refreshed by the main thread.
+ */
+static atomic<int> current_uv_index(0);
+
+/**
+ * @brief Protects station_uv_sensor.
+ */
+static mutex station_uv_lock;
+
+/**
+ * @brief Whether the last frame of each station had the UV index of its own
+ * UV sensor. The UV API is called while some station has none.
+ */
+static map<string, bool> station_uv_sensor;
+
+/**
+ * @brief Record if the last frame of a station had its own UV index
+ * 
+ * @param station_id Identifier of the station
+ * @param uv_sensor True if the UV index of the frame was valid
+ */
+static void set_station_uv_sensor(const std::string& station_id, bool uv_sensor)
+{
+    lock_guard<mutex> guard(station_uv_lock);
+
+    station_uv_sensor[station_id] = uv_sensor;
+}
+
+/**
+ * @brief Check if the UV index of the API is used by some station
+ * 
+ * @return true No station has reported yet, or some station has no UV index
+ * of its own in its last frame
+ * @return false Every station has a UV sensor working
+ */
+static bool uv_api_needed()
+{
+    lock_guard<mutex> guard(station_uv_lock);
+
+    if (station_uv_sensor.empty())
+        return true;
+    for (const auto& station : station_uv_sensor) {
+        if (!station.second)
+            return true;
+    }
+    return false;
+}
+
+static_assert(OBSERVATION_CHANNELS == TE923_FRAME_SENSORS, "An Observation has to hold every channel of a frame");
+
+/**
+ * @brief Fields of the remote sensor 1, the frame is discarded if none of
+ * them is available.
+ */
+static const uint32_t REMOTE_SENSOR_FIELDS = (DECODED_TEMPERATURE | DECODED_HUMIDITY) << 1;
+
+/**
+ * @brief Number of frames discarded by process_frame(), by reason: no
+ * pressure, no remote sensor and strange RealFeel©.
+ */
+static atomic<unsigned long> discarded_frames[3];
+
 /**
  * @brief Main function from where the different calls to the modules are done
  * and coordinated to obtain the data, process it, and send it to the outside.
  * 
+ * Each attached station is sampled by its own worker, which calls
+ * handle_station_frame() with every frame read, and its observations are
+ * stored by the writer thread of the station. The main thread keeps the UV
+ * index of the API updated while some station has no valid UV index of its
+ * own, and those frames use it. Sending SIGUSR1 to the program dumps the
+ * last USB transfers to stderr.
+ * 
+ * Accepted options:
+ *  - --async: use the event-driven USB transfers instead of the blocking ones.
+ *  - --large-memory: the stations have the large history memory.
+ *  - --capture <dir>: append every raw frame received to <dir>/<station>.frames
+ *  - --replay <file>: instead of reading the stations, feed the frames of a
+ *      capture file through the pipeline, as fast as possible.
+ *  - --speed <factor>: replay the frames keeping their original spacing,
+ *      divided by the factor.
+ *  - --simulate <rate>: instead of reading the stations, feed frames of a
+ *      simulated station at <rate> frames per second (0 for no limit).
+ *  - --frames <count>: number of frames to simulate (0 for no limit).
+ *  - --error-rate <p>: probability of each error pattern in the simulated
+ *      frames.
+ *  - --sink <null|stdout|db>: where the observations of the replayed or
+ *      simulated frames are stored. By default the replayed ones go to the
+ *      DB, and the simulated ones are not stored anywhere, so the time
+ *      printed is the one of the pipeline alone.
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments of the program
  * @return int Result of the program execution
  */
-int main() {
+int main(int argc, char* argv[]) {
     /* Variables declaration */
-    unsigned char receive_buffer[BUFLEN];
-    Observation current_obs;
-    int aux_counter = 0;
+    DeviceManager device_manager;
     int iterCounter = 0;
-    short int retValue = 0;
     bool keepRecording = true;
     int uv_index = 0;
-    bool temp_warn = false;
+    bool uv_index_stale = true;
+    string replay_path;
+    double replay_speed = 0;
+    double simulate_rate = -1;
+    long simulate_frames = 0;
+    SimulationErrors simulate_errors = {0, 0, 0, 0};
+    string sink_name;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--async") == 0) {
+            device_manager.setAsyncMode(true);
+        } else if (strcmp(argv[i], "--large-memory") == 0) {
+            device_manager.setHistoryRecords(TE923_HISTORY_RECORDS_LARGE);
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            device_manager.setCaptureDir(argv[++i]);
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            replay_speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--simulate") == 0 && i + 1 < argc) {
+            simulate_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            simulate_frames = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--error-rate") == 0 && i + 1 < argc) {
+            simulate_errors.crc_rate = atof(argv[++i]);
+            simulate_errors.sensor_lost_rate = simulate_errors.crc_rate;
+            simulate_errors.no_link_rate = simulate_errors.crc_rate;
+            simulate_errors.out_of_range_rate = simulate_errors.crc_rate;
+        } else if (strcmp(argv[i], "--sink") == 0 && i + 1 < argc) {
+            sink_name = argv[++i];
+            if (!sink_of_name(sink_name)) {
+                cerr << "Unknown sink " << sink_name << endl;
+                return 1;
+            }
+        } else {
+            cerr << "Unknown option " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    if (!replay_path.empty())
+    {
+        ReplayFrameSource replay_source(replay_speed);
+        if (replay_source.open(replay_path) < 0)
+            return 1;
+        run_frame_source(replay_source, station_id_of_file(replay_path), sink_of_name(sink_name.empty() ? "db" : sink_name));
+        cerr << replay_source.getSkipped() << " frames skipped by their CRC" << endl;
+        return 0;
+    }
+
+    if (simulate_rate >= 0)
+    {
+        SimulatedFrameSource simulated_source(simulate_rate, simulate_frames, 1);
+        simulated_source.setErrors(simulate_errors);
+        run_frame_source(simulated_source, "simulated", sink_of_name(sink_name.empty() ? "null" : sink_name));
+        return 0;
+    }
+
+    /* Before any thread is started, so all of them leave the signal to it */
+    UsbTracer::dumpOnSignal(SIGUSR1);
+
+    if (device_manager.start(handle_station_frame) < 0)
+        return 1;
 
     while (keepRecording)
     {
+        /* A refresh skipped while every station had its own UV index is done once one lacks it */
         if ((iterCounter % 120) == 0)
+            uv_index_stale = true;
+
+        if (uv_index_stale && uv_api_needed())
         {
             /* Call to the UV API to get current value */
             uv_index = obtain_current_uv_index();
             if (uv_index < 0)
                 uv_index = 0;
+            current_uv_index = uv_index;
+            uv_index_stale = false;
         }
-        /* Variables initialization */
-        current_obs = Observation();
-        temp_warn = false;
 
-        /* Obtain the data from the USB device */
-        retValue = obtain_usb_data((unsigned char*)&receive_buffer);
-        if (retValue < 0)
-        {
-            this_thread::sleep_for(chrono::seconds(30));
-            iterCounter++;
-            continue;
-        }
+        if ((iterCounter % 120) == 0)
+            dump_diagnostics(cerr);
 
-        /* Process & decode the pressure value */
-        current_obs.setPressure(decode_pressure(receive_buffer));
-        cout << "Current PRESSURE is " << current_obs.getPressure() << endl;
-        if (current_obs.getPressure() < 900 || current_obs.getPressure() > 1100)
-        {
-            cerr << "Aborting parsing, invalid values" << endl;
-            this_thread::sleep_for(chrono::seconds(30));
-            iterCounter++;
-            continue;
-        }
+        this_thread::sleep_for(chrono::seconds(30));
+        iterCounter++;
+    }
 
-        /* Process & decode the temperature values */
-        aux_counter = 0;
-        for (auto it : decode_temperature(receive_buffer))
-        {
-            current_obs.setTemperature(it, aux_counter++);
-            cout << "Current TEMPERATURE " << aux_counter-1 << " is " << current_obs.getTemperature(aux_counter-1) << endl;
-        }
-        if (current_obs.getTemperature(1) == 0.0)
-        {
-            temp_warn = true;
-        }
+    device_manager.stop();
 
-        /* Process & decode the humidity values */
-        aux_counter = 0;
-        for (auto it : decode_humidity(receive_buffer))
-        {
-            current_obs.setHumidity(it, aux_counter++);
-            cout << "Current HUMIDITY " << aux_counter-1 << " is " << current_obs.getHumidity(aux_counter-1) << endl;
-        }
-        if (temp_warn &&current_obs.getHumidity(1) == 0)
+    cout << "End of the program" << endl;
+    return 0;
+}
+
+/**
+ * @brief Feed all the frames of a source through the pipeline
+ * 
+ * Used for the sources other than the real stations. The frames are checked
+ * as the USB layer would do, and the valid ones are passed to
+ * handle_station_frame() as if they were just read. The writer thread is not
+ * started, so each observation is stored before the next frame is read and
+ * none is dropped.
+ * 
+ * @param source Source of the frames
+ * @param station_id Identifier of the station of the frames
+ * @param sink Where the observations are stored
+ * @return int Number of frames passed to the pipeline, negative if the
+ * source failed.
+ */
+int run_frame_source(FrameSource &source, const std::string& station_id, ObservationSink sink)
+{
+    FramePool pool;
+    FrameHandle slot;
+    ObservationWriter writer(station_id, sink);
+    short int retValue;
+    int processed = 0;
+    int rejected = 0;
+    int not_stored = 0;
+
+    auto start = chrono::steady_clock::now();
+    while (true)
+    {
+        /* Read each frame in place into a slot of the pool */
+        slot.reset();
+        slot = pool.acquire();
+        retValue = source.readFrame(slot.frame(), slot.timestamp());
+        if (retValue != 0)
+            break;
+
+        if (!check_crc(slot.frame()))
         {
-            cerr << "Aborting parsing, strange values" << endl;
-            this_thread::sleep_for(chrono::seconds(30));
-            iterCounter++;
+            rejected++;
             continue;
         }
 
-        /* Process & decode the wind chill value */
-        current_obs.setWindChill(decode_wind_chill(receive_buffer));
-        cout << "Current WIND CHILL is " << current_obs.getWindChill() << endl;
+        if (handle_station_frame(station_id, slot, writer) < 0)
+            not_stored++;
+        processed++;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
 
-        /* Process & decode the wind gust value */
-        current_obs.setWindGust(decode_wind_gust(receive_buffer));
-        cout << "Current WIND GUST is " << current_obs.getWindGust() << endl;
+    cerr << "Processed " << processed << " frames (" << rejected << " with invalid CRC, "
+         << not_stored << " not stored) in " << elapsed.count() << " s" << endl;
+    dump_diagnostics(cerr);
 
-        /* Process & decode the wind speed value */
-        current_obs.setWindSpeed(decode_wind_speed(receive_buffer));
-        cout << "Current WIND SPEED is " << current_obs.getWindSpeed() << endl;
+    return retValue < 0 ? retValue : processed;
+}
 
-        /* Process & decode the wind direction value */
-        current_obs.setWindDir(decode_wind_dir(receive_buffer));
-        cout << "Current WIND DIR is " << current_obs.getWindDir() << endl;
+/**
+ * @brief Sink that drops the observations
+ * 
+ * @param obs Observation to store
+ * @return int Always 0
+ */
+static int null_sink(const Observation& obs)
+{
+    (void)obs;
+    return 0;
+}
 
-        /* Calculate the dew point from the current observation */
-        current_obs.calculateDewPoint();
-        cout << "Calculated DEW POINT is " << current_obs.getDewPoint() << endl;
+/**
+ * @brief Sink that writes the observations to stdout as line protocol
+ * 
+ * @param obs Observation to store
+ * @return int 0 if the point was written
+ */
+static int stdout_sink(const Observation& obs)
+{
+    format_line_protocol(cout, obs);
+    cout << '\n';
+    return cout ? 0 : -1;
+}
 
-        /* Calculate the RealFeel© from the current observation */
-        current_obs.calculateRealFeel(uv_index);
-        cout << "Calculated RealFeel© is " << current_obs.getRealFeel() << endl;
-        if (current_obs.getRealFeel() > 70)
-        {
-            cerr << "Aborting parsing, strange values" << endl;
-            this_thread::sleep_for(chrono::seconds(30));
-            iterCounter++;
-            continue;
-        }
+/**
+ * @brief Get the sink of the observations given by its name
+ * 
+ * @param name "null" to drop them, "stdout" to write them as line protocol,
+ * or "db" to store them with write_into_DB()
+ * @return ObservationSink Sink, empty if the name is unknown
+ */
+ObservationSink sink_of_name(const std::string& name)
+{
+    if (name == "null")
+        return null_sink;
+    if (name == "stdout")
+        return stdout_sink;
+    if (name == "db")
+        return write_into_DB;
+    return ObservationSink();
+}
 
-        /* Write into the DB */
-        write_into_DB(current_obs);
+/**
+ * @brief Print the frames discarded and the values not available
+ * 
+ * @param out Stream where the counters are printed
+ */
+void dump_diagnostics(std::ostream& out)
+{
+    /* The pending messages of the log first, so they keep their order */
+    log_flush();
+    out << "Discarded frames: " << discarded_frames[0].load(memory_order_relaxed) << " without pressure, "
+        << discarded_frames[1].load(memory_order_relaxed) << " without remote sensor, "
+        << discarded_frames[2].load(memory_order_relaxed) << " with strange RealFeel" << endl;
+    dump_decode_diagnostics(out);
+    ObservationWriter::dumpDiagnostics(out);
+}
 
-        this_thread::sleep_for(chrono::seconds(30));
-        iterCounter++;
+/**
+ * @brief Obtain the station identifier of a capture file
+ * 
+ * @param path Path of the capture file
+ * @return std::string Name of the file, without directory nor extension
+ */
+std::string station_id_of_file(const std::string& path)
+{
+    string station_id = path;
+    size_t pos;
+
+    pos = station_id.find_last_of('/');
+    if (pos != string::npos)
+        station_id = station_id.substr(pos + 1);
+    pos = station_id.find_last_of('.');
+    if (pos != string::npos)
+        station_id = station_id.substr(0, pos);
+
+    return station_id;
+}
+
+/**
+ * @brief Process a frame read from a station and send it to the DB
+ * 
+ * Called from the worker of each station with every frame read, either live
+ * or recovered from the station history.
+ * 
+ * The frame is decoded in place, into the Observation of its slot, which is
+ * published to the writer of the station to be stored in the DB from its
+ * thread.
+ * 
+ * @param station_id Identifier of the station that sent the frame
+ * @param frame Slot with the frame read from the station and the time when
+ * it was measured
+ * @param writer Writer storing the observations of the station
+ * @return short int Negative if the frame was valid but could not be stored
+ * (the queue of the writer was full, or a previous observation failed)
+ */
+short int handle_station_frame(const std::string& station_id, FrameHandle& frame, ObservationWriter& writer)
+{
+    Observation &current_obs = frame.observation();
+
+    current_obs.setTimestamp(frame.timestamp());
+    current_obs.setStationId(station_id);
+    LOG_DEBUG("Station %s", station_id.c_str());
+
+    if (process_frame(frame.frame(), current_obs, current_uv_index) < 0)
+        return 0;
+    set_station_uv_sensor(station_id, (current_obs.getValidFields() & DECODED_UV) != 0);
+
+    /* Queue it to be written into the DB */
+    return writer.publish(current_obs);
+}
+
+/**
+ * @brief Decode a frame into an Observation and calculate the derived values
+ * 
+ * The values are only printed at the debug level of the log (make Test), so
+ * the replays and the benchmarks do not wait for the terminal.
+ * 
+ * @param receive_buffer Frame read from the station
+ * @param current_obs Observation to fill
+ * @param uv_index Current UV index, used if the station has no UV sensor
+ * @return short int 0 if the Observation is valid, negative if it has to be
+ * discarded.
+ */
+short int process_frame(const RawFrame& receive_buffer, Observation &current_obs, int uv_index)
+{
+    DecodedFrame decoded = decode_frame(receive_buffer);
+
+    /* Discard the frames without the main values before any output */
+    if ((decoded.valid & DECODED_PRESSURE) == 0 || decoded.pressure < 900 || decoded.pressure > 1100)
+    {
+        discarded_frames[0].fetch_add(1, memory_order_relaxed);
+        return -1;
+    }
+    if ((decoded.valid & REMOTE_SENSOR_FIELDS) == 0)
+    {
+        discarded_frames[1].fetch_add(1, memory_order_relaxed);
+        return -2;
+    }
+
+    current_obs.setValidFields(decoded.valid);
+    current_obs.setFieldStatus(decoded.status);
+
+    /* Process the pressure value */
+    current_obs.setPressure(decoded.pressure);
+    LOG_DEBUG("Current PRESSURE is %g", current_obs.getPressure());
+
+    /* Process the temperature and humidity values */
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++)
+    {
+        current_obs.setTemperature(decoded.temperature[i], i);
+        LOG_DEBUG("Current TEMPERATURE %d is %g", i, current_obs.getTemperature(i));
+    }
+    for (int i = 0; i < TE923_FRAME_SENSORS; i++)
+    {
+        current_obs.setHumidity(decoded.humidity[i], i);
+        LOG_DEBUG("Current HUMIDITY %d is %g", i, current_obs.getHumidity(i));
+    }
+
+    /* Process the wind values */
+    current_obs.setWindChill(decoded.wind_chill);
+    LOG_DEBUG("Current WIND CHILL is %g", current_obs.getWindChill());
+
+    current_obs.setWindGust(decoded.wind_gust);
+    LOG_DEBUG("Current WIND GUST is %g", current_obs.getWindGust());
+
+    current_obs.setWindSpeed(decoded.wind_speed);
+    LOG_DEBUG("Current WIND SPEED is %g", current_obs.getWindSpeed());
+
+    current_obs.setWindDir(decoded.wind_dir);
+    LOG_DEBUG("Current WIND DIR is %g", current_obs.getWindDir());
+
+    /* Process the rain and the UV index, from the station if it has a UV sensor */
+    current_obs.setRainfall(decoded.rain);
+    LOG_DEBUG("Current RAINFALL is %g", current_obs.getRainfall());
+
+    if ((decoded.valid & DECODED_UV) != 0)
+    {
+        current_obs.setUVIndex(decoded.uv);
+        uv_index = lround(decoded.uv);
+    }
+    else
+    {
+        current_obs.setUVIndex(uv_index);
+    }
+    LOG_DEBUG("Current UV INDEX is %g", current_obs.getUVIndex());
+
+    /* Calculate the dew point from the current observation */
+    current_obs.calculateDewPoint();
+    LOG_DEBUG("Calculated DEW POINT is %g", current_obs.getDewPoint());
+
+    /* Calculate the RealFeel© from the current observation */
+    current_obs.calculateRealFeel(uv_index);
+    LOG_DEBUG("Calculated RealFeel© is %g", current_obs.getRealFeel());
+    if (current_obs.getRealFeel() > 70)
+    {
+        discarded_frames[2].fetch_add(1, memory_order_relaxed);
+        return -3;
     }
 
-    cout << "End of the program" << endl;
     return 0;
 }
 
@@ -203,167 +552,3 @@ void printdev (libusb_device *dev) {
 
     libusb_free_config_descriptor(config);
 }
-
-/**
- * @brief Function to obtain the info from the USB device
- * 
- * Through this function, via the libusb, a dump signal is sent to the specified
- * USB device. After that, the USB device returns a message with the information
- * related to the Weather Station, coded into an array of unsigned chars.
- * 
- * @param receive_buffer Buffer where the retreived information is stored. 
- * @return short int Result of the execution of the function.
- */
-short int obtain_usb_data(unsigned char* receive_buffer)
-{
-    libusb_device **devs;
-    libusb_device_handle *dev_handle;
-    libusb_context *ctx;
-
-    int retValue;
-    int iInterface;
-    ssize_t counter;
-    unsigned char control_data[] = {0x05, 0x0AF, 0x00, 0x00, 0x00, 0x00, 0xAF, 0xFE};
-    int control_addr = 0x020001;
-    int transferred_len = 0;
-    int bytes_transferred = 0;
-    int total_transferred = 0;
-    unsigned char crc;
-    bool finish = false;
-    int transfer_attempts;
-
-    retValue = libusb_init(&ctx);
-    if (retValue < 0) {
-        cerr << "Error initializing libusb" << endl;
-        return 1;
-    }
-
-    //libusb_set_debug(ctx, 3); Deprecated
-
-    counter = libusb_get_device_list(ctx, &devs);
-    if (counter < 0) {
-        cerr << "Error listing the devices" << endl;
-        return 2;
-    }
-    #ifdef DEBUG 
-        cout << "There are " << counter << " devices in the list" << endl;
-        for (int i = 0; i < counter; i++) {
-            printdev(devs[i]);
-        }
-    #endif
-
-    dev_handle = libusb_open_device_with_vid_pid(ctx, 4400, 26625);
-    if (dev_handle == NULL) {
-        cerr << "Cannot open device" << endl;
-    } else {
-        #ifdef DEBUG 
-            cout << "Device opened" << endl;
-        #endif
-    }
-
-    libusb_free_device_list(devs, 1);
-
-    retValue = libusb_set_auto_detach_kernel_driver(dev_handle, 1);
-    if (retValue < 0) {
-        cerr << " Error auto-setting the kernel detach: " << libusb_strerror(libusb_error(retValue)) << endl;
-        if (libusb_kernel_driver_active(dev_handle, 0) == 1) {
-            cerr << "Kernel Driver Active" << endl;
-            if (libusb_detach_kernel_driver(dev_handle, 0) == 0) {
-                cerr << "Kernel Driver Detached" << endl;
-            } else {
-                cerr << "Error detaching the Kernel Driver" << endl;
-            }
-        } else {
-            cerr << "Kernel Driver not loaded" << endl;
-        }
-    }
-    
-    iInterface = libusb_claim_interface(dev_handle, 0);
-    if (iInterface < 0) {
-        cerr << "Cannot Claim Interface (" << libusb_strerror(libusb_error(iInterface)) << ")" << endl;
-        return 3;
-    }
-    #ifdef DEBUG 
-        cout << "Interface claimed" << endl;
-    #endif
-
-    retValue = libusb_set_interface_alt_setting(dev_handle, 0, 0);
-    if (retValue < 0) {
-        cerr << "Alternative setting not configured: " << libusb_strerror(libusb_error(retValue)) << endl;
-    }
-
-    transfer_attempts = 0;
-
-    do {
-
-        // Control transferece
-        control_data[4] = control_addr / 0x10000;
-        control_data[3] = ( control_addr - ( control_data[4] * 0x10000 ) ) / 0x100;
-        control_data[2] = control_addr - ( control_data[4] * 0x10000 ) - ( control_data[3] * 0x100 );
-        control_data[5] = ( control_data[1] ^ control_data[2] ^ control_data[3] ^ control_data[4] );
-
-        retValue = libusb_control_transfer(dev_handle, 0x21 & 0xff, 0x09 & 0xff, 0x0200 & 0xffff, 0x0000 & 0xffff, control_data, 0x08 & 0xffff, 50);
-        if (retValue < 0) {
-            cerr << "Error sending request: " << libusb_strerror(libusb_error(retValue)) << endl;
-        } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(300)); // Wait for 30 ms
-            #ifdef DEBUG 
-                cout << "Message sent" << endl;
-            #endif
-        }
-
-        // Receive transference
-        retValue = libusb_interrupt_transfer(dev_handle, 0x81 & 0xff, control_data, 0x8, &transferred_len, 50);
-        if (retValue < 0) {
-            //return -4;
-            cerr << "Error in the receive transfer." << endl;
-        }
-        while ( transferred_len > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(15)); // Wait for 0.15s
-            bytes_transferred = (int)(control_data[0]);
-            #ifdef DEBUG 
-            cout << "Control data 0: " << hex << (int)(control_data[0]) << dec << endl;
-            cout << "Data transferred: " << transferred_len << endl;
-            #endif
-            if (( total_transferred + bytes_transferred ) < BUFLEN )
-                memcpy (receive_buffer + total_transferred, control_data + 1, bytes_transferred);
-            total_transferred += bytes_transferred;
-            libusb_interrupt_transfer(dev_handle, 0x81 & 0xff, control_data, 0x8, &transferred_len, 50);
-        }
-        #ifdef DEBUG 
-        cout << "Message received" << endl;
-
-        for (int i = 0; i < BUFLEN; i++) {
-            cout << "Char [" << i << "]: ";
-            cout << hex << static_cast<int>(receive_buffer[i]) << dec << endl;
-        }
-        #endif
-        // CRC Calculation
-        crc = 0x00;
-        for (int i = 0; i <= 32; i++ ) {
-            crc = crc ^ receive_buffer[i];
-        }
-
-        if (crc == receive_buffer[33]){
-            finish = true;
-        } 
-        if (crc == 0x5a) {
-            finish = true;
-        }
-
-        #ifdef DEBUG
-        cout << "CRC: " << hex << (int)crc << dec << endl;
-        cout << "Rbuf[33]: " << hex << (int)receive_buffer[33] << dec << endl;
-        cout << "Rbuf[0]: " << hex << (int)receive_buffer[0] << dec << endl;
-        #endif
-
-        transfer_attempts++;
-
-    } while (finish == false && transfer_attempts < 10);
-
-    libusb_close(dev_handle);
-    libusb_exit(ctx);
-
-    if (transfer_attempts == 10)
-        return -1;
-}
\ No newline at end of file
@@ -11,12 +11,26 @@
  * size of the array where the USB data is stored and the functions headers.
  */
 
+#ifndef MAIN_H
+#define MAIN_H
+
+#include <ostream>
+#include <string>
 #include <libusb-1.0/libusb.h>
 
-/**
- * @brief Size of the data buffer where USB data is stored
- */
-const int BUFLEN = 35;
+#include "data_decoder.h"
+#include "FrameSource.h"
+#include "Observation.h"
+#include "ObservationWriter.h"
+
+class FrameHandle;
 
 void printdev(libusb_device *dev);
-short int obtain_usb_data(unsigned char* receive_buffer);
\ No newline at end of file
+int run_frame_source(FrameSource &source, const std::string& station_id, ObservationSink sink);
+ObservationSink sink_of_name(const std::string& name);
+std::string station_id_of_file(const std::string& path);
+void dump_diagnostics(std::ostream& out);
+short int handle_station_frame(const std::string& station_id, FrameHandle& frame, ObservationWriter& writer);
+short int process_frame(const RawFrame& receive_buffer, Observation &current_obs, int uv_index);
+
+#endif
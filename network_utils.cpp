@@ -21,10 +21,33 @@
 #include <string>
 #include "json.hpp"
 
+#include "line_protocol.h"
 #include "Observation.h"
 
 using json = nlohmann::json;
 
+/**
+ * @brief Function to quote a string literal of InfluxQL
+ * 
+ * The backslashes and single quotes of the value are escaped with a
+ * backslash, so the value cannot end the literal.
+ * 
+ * @param value Value of the literal
+ * @return std::string Literal between single quotes
+ */
+static std::string quote_influxql_string(const std::string& value)
+{
+    std::string literal = "'";
+
+    for (char c : value) {
+        if (c == '\\' || c == '\'')
+            literal += '\\';
+        literal += c;
+    }
+    literal += '\'';
+    return literal;
+}
+
 /**
  * @brief Callback to the cURL HTTP request
  * 
@@ -97,61 +120,128 @@ int obtain_current_uv_index()
  * 
  * Using the cURL utilities via libcurl4, it makes a POST API request to
  * store the values registered into a InfluxDB present in the same machine
- * with the comma-separated pairs of sensor=value
+ * with the comma-separated pairs of sensor=value, stamped with the timestamp
+ * of the Observation (so the records recovered from the station history are
+ * stored in their original time). The point is formatted by
+ * format_line_protocol().
  * 
  * More info at https://docs.influxdata.com/influxdb/v1.8/guides/write_data/
  * 
- * @return int Status of the DB insertion
+ * @param obs Observation to store
+ * @return int Status of the DB insertion (0 if the point was written)
  */
-int write_into_DB(Observation obs)
+int write_into_DB(const Observation& obs)
 {
     CURL *curl_unit;
-    struct curl_slist *list = NULL;
     std::stringstream ssBuffer;
+    std::string point;
     std::string readBuffer;
     int callResult;
-    wchar_t outMsg[1024];
+    long response_code = 0;
 
     curl_unit = curl_easy_init();
-    ssBuffer.str("");
-    memset(outMsg, '\0', 1024);
 
     if (curl_unit)
     {
-        ssBuffer << "curl -i -XPOST \"http://localhost:8086/write?db=demo\" --data-binary \"observation temp=" << obs.getTemperature(1) << ",humid=" << obs.getHumidity(1) << "i,press=" << obs.getPressure() \
-        << ",wind_dir=" << obs.getWindDir() << ",wind_spd=" << obs.getWindSpeed() << ",wind_gst=" << obs.getWindGust() << ",rfel=" \
-        << obs.getRealFeel() << "\"";
-
-        std::cerr << "[DEBUG] Insert: " << ssBuffer.str() << std::endl;
-/*
-        curl_easy_setopt(curl_unit, CURLOPT_URL, "http://localhost:8086/write?db=demo");
-        list = curl_slist_append(list, "Content-type: charset=ASCII");
-        curl_easy_setopt(curl_unit, CURLOPT_HTTPHEADER, list);
-        curl_easy_setopt(curl_unit, CURLOPT_POSTFIELDS, outMsg);
-        curl_easy_setopt(curl_unit, CURLOPT_POSTFIELDSIZE, strlen((char*)outMsg));
+        format_line_protocol(ssBuffer, obs);
+        point = ssBuffer.str();
+
+        std::cerr << "[DEBUG] Insert: " << point << std::endl;
+
+        curl_easy_setopt(curl_unit, CURLOPT_URL, "http://localhost:8086/write?db=demo&precision=s");
+        curl_easy_setopt(curl_unit, CURLOPT_POSTFIELDS, point.c_str());
+        curl_easy_setopt(curl_unit, CURLOPT_POSTFIELDSIZE, (long)point.size());
 
         curl_easy_setopt(curl_unit, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl_unit, CURLOPT_WRITEDATA, &readBuffer);
 
         callResult = curl_easy_perform(curl_unit);
-        std::cerr << "[DEBUG] Result of the call: " << callResult << std::endl;
-        std::cerr << "[DEBUG] Result: " << readBuffer << std::endl;
+        if (callResult == 0)
+            curl_easy_getinfo(curl_unit, CURLINFO_RESPONSE_CODE, &response_code);
+        curl_easy_cleanup(curl_unit);
 
-        long response_code;
-        curl_easy_getinfo(curl_unit, CURLINFO_RESPONSE_CODE, &response_code);
+        if (callResult != 0)
+        {
+            std::cerr << "[DEBUG] Result of the call: " << callResult << std::endl;
+            return -1;
+        }
+
+        /* The point is only written when the DB answers 204 (No Content) */
+        if (response_code != 204)
+        {
+            std::cerr << "[DEBUG] Code: " << response_code << " " << readBuffer << std::endl;
+            return -1;
+        }
+    }
+    else
+    {
+        std::cerr << "cURL library could not be initialized." << std::endl;
+        return -1;
+    }
 
-        std::cerr << "[DEBUG] Code: " << response_code << std::endl;
+    return 0;
+}
 
-        curl_slist_free_all(list);
-        curl_easy_cleanup(curl_unit);*/
+/**
+ * @brief Function to obtain the timestamp of the last observation stored
+ * 
+ * Using the cURL utilities via libcurl4, it makes a GET API request to the
+ * InfluxDB present in the same machine asking for the last observation of a
+ * station, in order to know from when the history of the station has to be
+ * recovered.
+ * 
+ * More info at https://docs.influxdata.com/influxdb/v1.8/guides/query_data/
+ * 
+ * @param station_id Identifier of the station
+ * @return long Timestamp of the last observation, 0 if there is none, or
+ * negative if the DB could not be queried.
+ */
+long obtain_last_stored_timestamp(const std::string& station_id)
+{
+    CURL *curl_unit;
+    std::string readBuffer;
+    std::stringstream ssUrl;
+    char *query;
+    int callResult;
+    long last_timestamp = 0;
+
+    curl_unit = curl_easy_init();
+
+    if (curl_unit)
+    {
+        query = curl_easy_escape(curl_unit, ("SELECT last(temp) FROM observation WHERE station=" + quote_influxql_string(station_id)).c_str(), 0);
+        ssUrl << "http://localhost:8086/query?db=demo&epoch=s&q=" << query;
+        curl_free(query);
+
+        curl_easy_setopt(curl_unit, CURLOPT_URL, ssUrl.str().c_str());
+        curl_easy_setopt(curl_unit, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(curl_unit, CURLOPT_WRITEDATA, &readBuffer);
+
+        callResult = curl_easy_perform(curl_unit);
+        curl_easy_cleanup(curl_unit);
+        if (callResult != 0)
+        {
+            std::cerr << "[DEBUG] Result of the call: " << callResult << std::endl;
+            return -1;
+        }
+
+        #ifdef DEBUG
+            std::cout << readBuffer << std::endl;
+        #endif
 
-        system(ssBuffer.str().c_str());
+        json apiResult = json::parse(readBuffer, nullptr, false);
+        if (apiResult.is_discarded())
+            return -1;
+
+        json series = apiResult["results"][0]["series"];
+        if (series.is_array() && !series.empty() && series[0]["values"][0][0].is_number())
+            last_timestamp = series[0]["values"][0][0].get<long>();
+
+        return last_timestamp;
     }
     else
     {
         std::cerr << "cURL library could not be initialized." << std::endl;
         return -1;
     }
-
-    return callResult;
 }
@@ -15,8 +15,16 @@
  *  - Send the observation data to the Weather Underground API
  */
 
+#ifndef NETWORK_UTILS_HPP
+#define NETWORK_UTILS_HPP
+
+#include <string>
+
 #include "Observation.h"
 
 /* Functions definition */
 int obtain_current_uv_index();
-int write_into_DB(Observation obs);
\ No newline at end of file
+int write_into_DB(const Observation& obs);
+long obtain_last_stored_timestamp(const std::string& station_id);
+
+#endif